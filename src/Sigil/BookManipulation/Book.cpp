@@ -24,6 +24,7 @@
 #include <QtCore/QtCore>
 #include <QtCore/QFileInfo>
 #include <QtCore/QFutureSynchronizer>
+#include <QtCore/QRegularExpression>
 #include <QtConcurrent/QtConcurrent>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QProgressDialog>
@@ -35,6 +36,7 @@
 #include "Misc/TempFolder.h"
 #include "Misc/Utility.h"
 #include "Misc/HTMLSpellCheck.h"
+#include "ResourceObjects/CSSResource.h"
 #include "ResourceObjects/HTMLResource.h"
 #include "ResourceObjects/NCXResource.h"
 #include "ResourceObjects/OPFResource.h"
@@ -48,6 +50,19 @@ using boost::make_tuple;
 using boost::tuple;
 using boost::tie;
 
+// Matches every place a path update may rewrite: href and src attributes
+// (PerformXMLUpdates) and url(), @import and quoted src/background values
+// (PerformCSSUpdates). Matching more than that is harmless.
+static const QRegularExpression FILE_REFERENCE(
+    "(?:href|src)\\s*=\\s*(?:\"([^\"]*)\"|'([^']*)')"
+    "|url\\(\\s*(?:\"([^\"]*)\"|'([^']*)'|([^\\)]*))"
+    "|(?:(?:src|background|background-image)\\s*:|@import)[^;\\}\\(\"']*(?:\"([^\"]*)\"|'([^']*)')",
+    QRegularExpression::CaseInsensitiveOption);
+// The capture groups of FILE_REFERENCE that hold attribute values
+static const int LAST_ATTRIBUTE_GROUP = 2;
+// Character references and the entities predefined by XML
+static const QRegularExpression XML_ENTITY("&(?:#(\\d+)|#[xX]([0-9a-fA-F]+)|(amp|lt|gt|quot|apos));");
+
 static const QString FIRST_CSS_NAME   = "Style0001.css";
 static const QString FIRST_SVG_NAME   = "Image0001.svg";
 static const QString PLACEHOLDER_TEXT = "PLACEHOLDER";
@@ -345,6 +360,18 @@ CSSResource &Book::CreateEmptyCSSFile()
 }
 
 
+QList< Resource * > Book::AddExistingFiles(const QStringList &fullfilepaths)
+{
+    QList< Resource * > resources = m_Mainfolder.AddContentFilesToFolder(fullfilepaths);
+
+    if (!resources.isEmpty()) {
+        SetModified(true);
+    }
+
+    return resources;
+}
+
+
 SVGResource &Book::CreateEmptySVGFile()
 {
     TempFolder tempfolder;
@@ -393,7 +420,7 @@ HTMLResource &Book::CreateSectionBreakOriginalResource(const QString &content, H
 }
 
 
-void Book::CreateNewSections(const QStringList &new_sections, HTMLResource &original_resource)
+void Book::CreateNewSections(const XhtmlDoc::SGFSectionSplits &new_sections, HTMLResource &original_resource)
 {
     int original_position = GetOPF().GetReadingOrder(original_resource);
     Q_ASSERT(original_position >= 0);
@@ -422,7 +449,8 @@ void Book::CreateNewSections(const QStringList &new_sections, HTMLResource &orig
     for (int i = 0; i < new_sections.count(); ++i) {
         int reading_order = next_reading_order + i;
         NewSection sectionInfo;
-        sectionInfo.source = new_sections.at(i);
+        sectionInfo.splits = &new_sections;
+        sectionInfo.section_index = i;
         sectionInfo.reading_order = reading_order;
         sectionInfo.temp_folder_path = tempfolder.GetPath();
         sectionInfo.new_file_prefix = new_file_prefix;
@@ -468,6 +496,15 @@ void Book::CreateNewSections(const QStringList &new_sections, HTMLResource &orig
         }
     }
 
+    // The new files were created without touching the OPF,
+    // so add all of them to it in one go.
+    QList< Resource * > created_resources;
+
+    for (int i = 1; i < new_files.count(); ++i) {
+        created_resources.append(new_files.at(i));
+    }
+
+    GetOPF().AddResources(created_resources);
     // Update anchor references between fragment ids in the new files. Since these all came from one single
     // file it's safe to assume that the fragment ids are all unique (since otherwise the references would be broken).
     AnchorUpdates::UpdateAllAnchorsWithIDs(new_files);
@@ -483,8 +520,7 @@ void Book::CreateNewSections(const QStringList &new_sections, HTMLResource &orig
 
 bool Book::IsDataWellFormed(HTMLResource &html_resource)
 {
-    XhtmlDoc::WellFormedError error = XhtmlDoc::WellFormedErrorForSource(html_resource.GetText());
-    return error.line == -1;
+    return html_resource.FileIsWellFormed();
 }
 
 
@@ -814,23 +850,197 @@ QStringList Book::GetWordsInHTMLFileMapped(HTMLResource *html_resource)
 
 QHash<QString, int> Book::GetUniqueWordsInHTMLFiles()
 {
-    QHash<QString, int> all_words;
     const QList<HTMLResource *> html_resources = m_Mainfolder.GetResourceTypeList< HTMLResource >(false);
-    QFuture<QStringList> future = QtConcurrent::mapped(html_resources, GetWordsInHTMLFileMapped);
+    QList<HTMLResource *> modified_resources;
+    QSet<QString> identifiers;
+    foreach(HTMLResource * html_resource, html_resources) {
+        const QString identifier = html_resource->GetIdentifier();
+        identifiers.insert(identifier);
+
+        if (!m_FileWordCounts.contains(identifier) ||
+            m_FileWordCounts.value(identifier).revision != html_resource->GetRevision()) {
+            modified_resources.append(html_resource);
+        }
+    }
+    // Forget the files that were removed from the book.
+    foreach(QString identifier, m_FileWordCounts.keys()) {
+        if (!identifiers.contains(identifier)) {
+            MergeWordCounts(m_FileWordCounts.value(identifier).counts, -1);
+            m_FileWordCounts.remove(identifier);
+        }
+    }
+    QFuture< boost::tuple<QString, int, QHash<QString, int> > > future =
+        QtConcurrent::mapped(modified_resources, GetWordCountsInHTMLFileMapped);
 
     for (int i = 0; i < future.results().count(); i++) {
-        QStringList result = future.resultAt(i);
-        foreach (QString word, result) {
-            if (all_words.contains(word)) {
-                all_words[word]++;
+        FileWordCounts file_counts;
+        QString identifier;
+        tie(identifier, file_counts.revision, file_counts.counts) = future.resultAt(i);
+
+        if (m_FileWordCounts.contains(identifier)) {
+            MergeWordCounts(m_FileWordCounts.value(identifier).counts, -1);
+        }
+
+        MergeWordCounts(file_counts.counts, 1);
+        m_FileWordCounts[identifier] = file_counts;
+    }
+
+    return m_BookWordCounts;
+}
+
+boost::tuple<QString, int, QHash<QString, int> > Book::GetWordCountsInHTMLFileMapped(HTMLResource *html_resource)
+{
+    // The revision has to be read before the text, so a change made
+    // in between makes the counts look out of date rather than current.
+    const int revision = html_resource->GetRevision();
+    QHash<QString, int> counts;
+    foreach(QString word, HTMLSpellCheck::GetAllWords(html_resource->GetText())) {
+        counts[word]++;
+    }
+    return make_tuple(html_resource->GetIdentifier(), revision, counts);
+}
+
+void Book::MergeWordCounts(const QHash<QString, int> &counts, int sign)
+{
+    QHashIterator<QString, int> it(counts);
+
+    while (it.hasNext()) {
+        it.next();
+        int &total = m_BookWordCounts[it.key()];
+        total += sign * it.value();
+
+        if (total <= 0) {
+            m_BookWordCounts.remove(it.key());
+        }
+    }
+}
+
+QList<Resource *> Book::GetResourcesReferencingFiles(const QStringList &filenames)
+{
+    QList<TextResource *> text_resources;
+    foreach(HTMLResource * html_resource, m_Mainfolder.GetResourceTypeList< HTMLResource >(false)) {
+        text_resources.append(html_resource);
+    }
+    foreach(CSSResource * css_resource, m_Mainfolder.GetResourceTypeList< CSSResource >(false)) {
+        text_resources.append(css_resource);
+    }
+    QList<TextResource *> modified_resources;
+    QSet<QString> identifiers;
+    foreach(TextResource * text_resource, text_resources) {
+        const QString identifier = text_resource->GetIdentifier();
+        identifiers.insert(identifier);
+
+        if (!m_FileReferences.contains(identifier) ||
+            m_FileReferences.value(identifier).revision != text_resource->GetRevision()) {
+            modified_resources.append(text_resource);
+        }
+    }
+    // Forget the files that were removed from the book.
+    foreach(QString identifier, m_FileReferences.keys()) {
+        if (!identifiers.contains(identifier)) {
+            m_FileReferences.remove(identifier);
+        }
+    }
+    QFuture< boost::tuple<QString, int, QSet<QString> > > future =
+        QtConcurrent::mapped(modified_resources, GetReferencedFilenamesMapped);
+
+    for (int i = 0; i < future.results().count(); i++) {
+        FileReferences references;
+        QString identifier;
+        tie(identifier, references.revision, references.filenames) = future.resultAt(i);
+        m_FileReferences[identifier] = references;
+    }
+
+    QList<Resource *> referencing_resources;
+    foreach(TextResource * text_resource, text_resources) {
+        const QSet<QString> &referenced = m_FileReferences[text_resource->GetIdentifier()].filenames;
+        foreach(QString filename, filenames) {
+            if (referenced.contains(filename)) {
+                referencing_resources.append(text_resource);
+                break;
             }
-            else {
-                all_words[word] = 1;
+        }
+    }
+    return referencing_resources;
+}
+
+// Attribute values have their entities decoded before the updates
+// compare them, so the index has to decode them the same way.
+static QString DecodeXMLEntities(const QString &value)
+{
+    if (!value.contains('&')) {
+        return value;
+    }
+
+    QString decoded;
+    int last_end = 0;
+    QRegularExpressionMatchIterator entities = XML_ENTITY.globalMatch(value);
+
+    while (entities.hasNext()) {
+        QRegularExpressionMatch entity = entities.next();
+        decoded.append(value.mid(last_end, entity.capturedStart() - last_end));
+        last_end = entity.capturedEnd();
+
+        if (entity.capturedStart(1) != -1 || entity.capturedStart(2) != -1) {
+            bool ok = false;
+            uint code = entity.capturedStart(1) != -1 ? entity.captured(1).toUInt(&ok, 10)
+                                                      : entity.captured(2).toUInt(&ok, 16);
+
+            if (ok && code > 0 && code <= 0x10FFFF) {
+                decoded.append(QString::fromUcs4(&code, 1));
+            } else {
+                decoded.append(entity.captured());
             }
+        } else {
+            const QString name = entity.captured(3);
+            decoded.append(name == "amp"  ? QChar('&')  :
+                           name == "lt"   ? QChar('<')  :
+                           name == "gt"   ? QChar('>')  :
+                           name == "quot" ? QChar('"')  :
+                                            QChar('\''));
         }
     }
 
-    return all_words;
+    decoded.append(value.mid(last_end));
+    return decoded;
+}
+
+boost::tuple<QString, int, QSet<QString> > Book::GetReferencedFilenamesMapped(TextResource *text_resource)
+{
+    // The revision has to be read before the text, so a change made
+    // in between makes the references look out of date rather than current.
+    const int revision = text_resource->GetRevision();
+    const QString text = text_resource->GetText();
+    QSet<QString> filenames;
+    QRegularExpressionMatchIterator references = FILE_REFERENCE.globalMatch(text);
+
+    while (references.hasNext()) {
+        QRegularExpressionMatch match = references.next();
+
+        for (int i = 1; i <= FILE_REFERENCE.captureCount(); ++i) {
+            if (match.capturedStart(i) == -1) {
+                continue;
+            }
+
+            // Updates compare the decoded path without any fragment id
+            QString value = match.captured(i);
+
+            if (i <= LAST_ATTRIBUTE_GROUP) {
+                value = DecodeXMLEntities(value);
+            }
+
+            QString path = Utility::URLDecodePath(value.trimmed());
+            int fragment_index = path.indexOf('#');
+
+            if (fragment_index != -1) {
+                path.truncate(fragment_index);
+            }
+
+            filenames.insert(path.mid(path.lastIndexOf('/') + 1));
+            break;
+        }
+    }
+    return make_tuple(text_resource->GetIdentifier(), revision, filenames);
 }
 
 QHash<QString, QStringList> Book::GetStylesheetsInHTMLFiles()
@@ -1010,15 +1220,17 @@ Book::NewSectionResult Book::CreateOneNewSection(NewSection section_info,
     QString filename = section_info.new_file_prefix % "_" % QString("%1").arg(section_info.file_suffix + 1, 4, 10, QChar('0')) + section_info.file_extension;
     QString fullfilepath = section_info.temp_folder_path + "/" + filename;
     Utility::WriteUnicodeTextFile("PLACEHOLDER", fullfilepath);
+    // The OPF is updated for all the new sections at once by the caller
     HTMLResource *html_resource = qobject_cast< HTMLResource * >(
-                                      &m_Mainfolder.AddContentFileToFolder(fullfilepath));
+                                      &m_Mainfolder.AddContentFileToFolder(fullfilepath, false));
     Q_ASSERT(html_resource);
+    const QString &source = section_info.splits->Section(section_info.section_index);
 
     if (html_updates.isEmpty()) {
-        html_resource->SetText(CleanSource::Clean(section_info.source));
+        html_resource->SetText(CleanSource::Clean(source));
     } else {
         html_resource->SetText(
-            XhtmlDoc::GetDomDocumentAsString(*PerformHTMLUpdates(CleanSource::Clean(section_info.source),
+            XhtmlDoc::GetDomDocumentAsString(*PerformHTMLUpdates(CleanSource::Clean(source),
                                              html_updates,
                                              QHash< QString, QString >()
                                                                 )().get()));
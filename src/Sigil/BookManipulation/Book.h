@@ -40,6 +40,7 @@ class HTMLResource;
 class NCXResource;
 class OPFResource;
 class Resource;
+class TextResource;
 
 /**
  * Represents the book loaded in the current MainWindow instance
@@ -170,6 +171,15 @@ public:
     HTMLResource &CreateHTMLCoverFile(QString text);
 
     CSSResource &CreateHTMLTOCCSSFile();
+
+    /**
+     * Adds existing files to the book as a single batch.
+     * The OPF is updated once for the whole batch.
+     *
+     * @param fullfilepaths The full paths to the files to add.
+     * @return The created resources.
+     */
+    QList< Resource * > AddExistingFiles(const QStringList &fullfilepaths);
     CSSResource &CreateIndexCSSFile();
 
     /**
@@ -192,11 +202,14 @@ public:
      * The only reason why we have an overload instead of just one function
      * with a default argument is because then Apple GCC 4.2 flakes out here.
      *
-     * @param new_sections The contents of the new sections.
+     * The new files are created and cleaned in parallel, and
+     * the OPF is updated once for all of them.
+     *
+     * @param new_sections The split offsets of the new sections.
      * @param originating_resource The original HTML section that sections
      * will be created after.
      */
-    void CreateNewSections(const QStringList &new_sections,
+    void CreateNewSections(const XhtmlDoc::SGFSectionSplits &new_sections,
                            HTMLResource &originalResource);
 
     /**
@@ -226,7 +239,22 @@ public:
     QSet<QString> GetWordsInHTMLFiles();
     static QStringList GetWordsInHTMLFileMapped(HTMLResource *html_resource);
 
+    /**
+     * Returns how often each word occurs in the HTML files.
+     * The counts are cached per file, so only the files modified
+     * since the last call are tokenized again.
+     */
     QHash<QString, int> GetUniqueWordsInHTMLFiles();
+    static boost::tuple<QString, int, QHash<QString, int> > GetWordCountsInHTMLFileMapped(HTMLResource *html_resource);
+
+    /**
+     * Returns the HTML and CSS files that may reference any of the given
+     * filenames, so path updates can skip the files that can't need them.
+     * The filenames each file references are cached, so only the files
+     * modified since the last call are scanned again.
+     */
+    QList<Resource *> GetResourcesReferencingFiles(const QStringList &filenames);
+    static boost::tuple<QString, int, QSet<QString> > GetReferencedFilenamesMapped(TextResource *text_resource);
 
     QHash<QString, QStringList> GetStylesheetsInHTMLFiles();
     static boost::tuple<QString, QStringList> GetStylesheetsInHTMLFileMapped(HTMLResource *html_resource);
@@ -327,8 +355,12 @@ private:
     // This is needed because QtConcurrent only seems to accept functions with
     //a maximum of 5 arguments.
     struct NewSection {
-        // The source code of the new section.
-        QString source;
+        // The split sections this one is taken from. The section
+        // source is only built from it by the worker creating the file.
+        const XhtmlDoc::SGFSectionSplits *splits;
+
+        // The index of this section in splits.
+        int section_index;
 
         // The reading order of the new section.
         int reading_order;
@@ -357,6 +389,28 @@ private:
         int reading_order;
     };
 
+    // The word counts of one HTML file.
+    struct FileWordCounts {
+        // The revision of the resource text the counts were taken from.
+        int revision;
+
+        QHash<QString, int> counts;
+    };
+
+    // The filenames referenced by one HTML or CSS file.
+    struct FileReferences {
+        // The revision of the resource text the references were taken from.
+        int revision;
+
+        QSet<QString> filenames;
+    };
+
+    /**
+     * Adds (or with a negative sign, removes) the word counts
+     * of one file to the book-wide word counts.
+     */
+    void MergeWordCounts(const QHash<QString, int> &counts, int sign);
+
     /**
      * Syncs the content of one resource to the disk.
      * @param resource The resource to be synced.
@@ -404,6 +458,22 @@ private:
      */
     bool m_IsModified;
 
+    /**
+     * The word counts of each HTML file, keyed on the resource identifier.
+     */
+    QHash< QString, FileWordCounts > m_FileWordCounts;
+
+    /**
+     * The sum of all the counts in m_FileWordCounts.
+     */
+    QHash< QString, int > m_BookWordCounts;
+
+    /**
+     * The filenames referenced by each HTML and CSS file,
+     * keyed on the resource identifier.
+     */
+    QHash< QString, FileReferences > m_FileReferences;
+
 };
 
 #endif // BOOK_H
@@ -23,6 +23,7 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QHashIterator>
+#include <QtCore/QScopedPointer>
 #include <QtGui/QFont>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QApplication>
@@ -31,46 +32,84 @@
 #include "BookManipulation/Book.h"
 #include "BookManipulation/BookReports.h"
 #include "BookManipulation/FolderKeeper.h"
+#include "BookManipulation/XhtmlDoc.h"
 #include "Misc/CSSInfo.h"
 #include "Misc/SettingsStore.h"
+#include "ResourceObjects/OPFResource.h"
 
-QList<BookReports::StyleData *> BookReports::GetHTMLClassUsage(QSharedPointer< Book > book, bool show_progress)
+QList<BookReports::ResourceSnapshot> BookReports::GetResourceSnapshots(QSharedPointer< Book > book)
+{
+    QList<BookReports::ResourceSnapshot> snapshots;
+    QHash<QString, QString> semantic_names = book->GetOPF().GetGuideSemanticNameForPaths();
+    foreach(Resource * resource, book->GetAllResources()) {
+        BookReports::ResourceSnapshot snapshot;
+        snapshot.identifier = resource->GetIdentifier();
+        snapshot.filename = resource->Filename();
+        snapshot.folder = resource->GetFolder();
+        snapshot.relative_path = resource->GetRelativePath();
+        snapshot.relative_path_to_oebps = resource->GetRelativePathToOEBPS();
+        snapshot.full_path = resource->GetFullPath();
+        snapshot.type = resource->Type();
+        snapshot.semantic_name = semantic_names.value(snapshot.relative_path_to_oebps);
+
+        if (snapshot.type == Resource::HTMLResourceType || snapshot.type == Resource::CSSResourceType) {
+            TextResource *text_resource = qobject_cast<TextResource *>(resource);
+
+            if (text_resource) {
+                snapshot.text = text_resource->GetText();
+            }
+        }
+
+        snapshots.append(snapshot);
+    }
+    return snapshots;
+}
+
+QList<BookReports::StyleData *> BookReports::GetHTMLClassUsage(const QList<BookReports::ResourceSnapshot> &resources, bool show_progress)
 {
-    QList<HTMLResource *> html_resources = book->GetFolderKeeper().GetResourceTypeList< HTMLResource >(false);
-    QList<CSSResource *> css_resources = book->GetFolderKeeper().GetResourceTypeList< CSSResource >(false);
     QList<BookReports::StyleData *> html_classes_usage;
+    int html_count = 0;
     // Save each CSS file's text so we don't have to reload it when checking each HTML file
     QHash<QString, QString> css_text;
-    foreach(CSSResource * css_resource, css_resources) {
-        QString css_filename = "../" + css_resource->GetRelativePathToOEBPS();
+    foreach(const BookReports::ResourceSnapshot & resource, resources) {
+        if (resource.type == Resource::HTMLResourceType) {
+            html_count++;
+        } else if (resource.type == Resource::CSSResourceType) {
+            QString css_filename = "../" + resource.relative_path_to_oebps;
 
-        if (!css_text.contains(css_filename)) {
-            css_text[css_filename] = css_resource->GetText();
+            if (!css_text.contains(css_filename)) {
+                css_text[css_filename] = resource.text;
+            }
         }
     }
 
-    // Display progress dialog
-    QProgressDialog progress(QObject::tr("Collecting classes..."), 0, 0, html_resources.count(), QApplication::activeWindow());
+    // Display progress dialog. Reports gathered on a worker thread
+    // must not create it at all.
+    QScopedPointer<QProgressDialog> progress;
     int progress_value = 0;
     if (show_progress) {
-        progress.setMinimumDuration(0);
-        progress.setValue(progress_value);
+        progress.reset(new QProgressDialog(QObject::tr("Collecting classes..."), 0, 0, html_count, QApplication::activeWindow()));
+        progress->setMinimumDuration(0);
+        progress->setValue(progress_value);
         qApp->processEvents();
     }
 
     // Check each file for classes to look for in inline and linked stylesheets
-    foreach(HTMLResource * html_resource, html_resources) {
+    foreach(const BookReports::ResourceSnapshot & html_resource, resources) {
+        if (html_resource.type != Resource::HTMLResourceType) {
+            continue;
+        }
+
         if (show_progress) {
-            progress.setValue(progress_value++);
+            progress->setValue(progress_value++);
             qApp->processEvents();
         }
 
-        QString html_filename = html_resource->Filename();
         // Get the unique list of classes in this file
-        QStringList classes_in_file = book->GetClassesInHTMLFile(html_filename);
+        QStringList classes_in_file = XhtmlDoc::GetAllDescendantClasses(*XhtmlDoc::LoadTextIntoDocument(html_resource.text).get()->getDocumentElement());
         classes_in_file.removeDuplicates();
         // Get the linked stylesheets for this file
-        QStringList linked_stylesheets = book->GetStylesheetsInHTMLFile(html_resource);
+        QStringList linked_stylesheets = XhtmlDoc::GetLinkedStylesheets(html_resource.text);
         // Look at each class from the HTML file
         foreach(QString class_name, classes_in_file) {
             QString found_location;
@@ -79,7 +118,7 @@ QList<BookReports::StyleData *> BookReports::GetHTMLClassUsage(QSharedPointer< B
             QString class_part = class_name.split(".").at(1);
             // Save the details for found or not found classes
             BookReports::StyleData *class_usage = new BookReports::StyleData();
-            class_usage->html_filename = html_resource->Filename();
+            class_usage->html_filename = html_resource.filename;
             class_usage->html_element_name = element_part;
             class_usage->html_class_name = class_part;
             // Look in each stylesheet
@@ -104,17 +143,19 @@ QList<BookReports::StyleData *> BookReports::GetHTMLClassUsage(QSharedPointer< B
     return html_classes_usage;
 }
 
-QList<BookReports::StyleData *> BookReports::GetCSSSelectorUsage(QSharedPointer< Book > book, QList<BookReports::StyleData *> html_classes_usage)
+QList<BookReports::StyleData *> BookReports::GetCSSSelectorUsage(const QList<BookReports::ResourceSnapshot> &resources, QList<BookReports::StyleData *> html_classes_usage)
 {
-    QList<CSSResource *> css_resources = book->GetFolderKeeper().GetResourceTypeList< CSSResource >(false);
     QList<BookReports::StyleData *> css_selectors_usage;
     // Now check the CSS files to see if their classes appear in an HTML file
-    foreach(CSSResource * css_resource, css_resources) {
-        QString text = css_resource->GetText();
-        CSSInfo css_info(text, true);
+    foreach(const BookReports::ResourceSnapshot & css_resource, resources) {
+        if (css_resource.type != Resource::CSSResourceType) {
+            continue;
+        }
+
+        CSSInfo css_info(css_resource.text, true);
         QList<CSSInfo::CSSSelector *> selectors = css_info.getClassSelectors();
         foreach(CSSInfo::CSSSelector * selector, selectors) {
-            QString css_filename = "../" + css_resource->GetRelativePathToOEBPS();
+            QString css_filename = "../" + css_resource.relative_path_to_oebps;
             // Save the details for found or not found classes
             BookReports::StyleData *selector_usage = new BookReports::StyleData();
             selector_usage->css_filename = css_filename;
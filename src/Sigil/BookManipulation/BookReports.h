@@ -46,8 +46,26 @@ public:
         int css_selector_position;
     };
 
-    static QList<BookReports::StyleData *> GetHTMLClassUsage(QSharedPointer< Book > book, bool show_progress = false);
-    static QList<BookReports::StyleData *> GetCSSSelectorUsage(QSharedPointer< Book > book, QList<BookReports::StyleData *> html_classes_usage);
+    // A copy of what the reports read from a resource. It is taken on the
+    // GUI thread so the reports can be gathered on worker threads without
+    // touching resources that may be edited or deleted in the meantime.
+    struct ResourceSnapshot {
+        QString identifier;
+        QString filename;
+        QString folder;
+        QString relative_path;
+        QString relative_path_to_oebps;
+        QString full_path;
+        Resource::ResourceType type;
+        QString semantic_name;
+        // Only set for HTML and CSS files
+        QString text;
+    };
+
+    static QList<BookReports::ResourceSnapshot> GetResourceSnapshots(QSharedPointer< Book > book);
+
+    static QList<BookReports::StyleData *> GetHTMLClassUsage(const QList<BookReports::ResourceSnapshot> &resources, bool show_progress = false);
+    static QList<BookReports::StyleData *> GetCSSSelectorUsage(const QList<BookReports::ResourceSnapshot> &resources, QList<BookReports::StyleData *> html_classes_usage);
 };
 
 #endif // BOOKREPORTS_H
@@ -19,12 +19,17 @@
 **
 *************************************************************************/
 
+#include <boost/bind/bind.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <buffio.h>
 
+#include <QtCore/QEventLoop>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QWriteLocker>
+#include <QtConcurrent/QtConcurrent>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QProgressDialog>
 #include <QRegularExpression>
@@ -595,27 +600,118 @@ QString CleanSource::PrettifyDOCTYPEHeader(const QString &source)
 
 QString CleanSource::NbspToEntity(const QString &source)
 {
-    QString new_source = source;
-    new_source.replace(QChar(160), "&nbsp;");
-    new_source.replace("&#160;", "&nbsp;");
-    new_source.replace("&#x00a0;", "&nbsp;");
-    new_source.replace("&#x00A0;", "&nbsp;");
+    const QChar nbsp(160);
+    const QString nbsp_entity("&nbsp;");
+    const QStringList nbsp_numeric_entities = QStringList() << "&#160;" << "&#x00a0;" << "&#x00A0;";
+    QString new_source;
+    int left_pos = 0;
+    int source_length = source.length();
+
+    // A single pass over the source, copying the text between
+    // the matches, instead of one full replace per variant.
+    for (int i = 0; i < source_length; ++i) {
+        int match_length = 0;
+
+        if (source.at(i) == nbsp) {
+            match_length = 1;
+        } else if (source.at(i) == QChar('&')) {
+            foreach(QString numeric_entity, nbsp_numeric_entities) {
+                if (source.midRef(i, numeric_entity.length()) == numeric_entity) {
+                    match_length = numeric_entity.length();
+                    break;
+                }
+            }
+        }
+
+        if (match_length == 0) {
+            continue;
+        }
+
+        if (left_pos == 0) {
+            new_source.reserve(source_length);
+        }
+
+        new_source.append(source.midRef(left_pos, i - left_pos));
+        new_source.append(nbsp_entity);
+        left_pos = i + match_length;
+        i = left_pos - 1;
+    }
+
+    // Nothing was replaced, so hand back the (implicitly shared) original.
+    if (left_pos == 0) {
+        return source;
+    }
+
+    new_source.append(source.midRef(left_pos));
     return new_source;
 }
 
 
-void CleanSource::ReformatAll(QList <HTMLResource *> resources, QString(clean_func)(const QString &source))
+bool CleanSource::ReformatAll(QList <HTMLResource *> resources,
+                              QString(clean_func)(const QString &source),
+                              bool show_progress)
 {
-    //QList <Resource *> resources = m_OPFModel.GetResourceListInFolder( Resource::HTMLResourceType );
-    QProgressDialog progress(QObject::tr("Cleaning..."), 0, 0, resources.count(), Utility::GetMainWindow());
+    QHash<HTMLResource *, QString> original_texts;
+    QMutex original_texts_mutex;
+
+    if (!show_progress) {
+        QtConcurrent::blockingMap(resources, boost::bind(ReformatOneResource, _1, clean_func, &original_texts, &original_texts_mutex));
+        return true;
+    }
+
+    QProgressDialog progress(QObject::tr("Cleaning..."), QObject::tr("Cancel"), 0, resources.count(), Utility::GetMainWindow());
+    progress.setWindowModality(Qt::WindowModal);
     progress.setMinimumDuration(PROGRESS_BAR_MINIMUM_DURATION);
-    int progress_value = 0;
-    progress.setValue(progress_value);
-    foreach(HTMLResource * resource, resources) {
-        progress.setValue(progress_value++);
-        qApp->processEvents();
-        QWriteLocker locker(&resource->GetLock());
-        resource->SetText(clean_func(resource->GetText()));
+    progress.setValue(0);
+    QFutureWatcher<void> watcher;
+    QEventLoop loop;
+    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)), &progress, SLOT(setValue(int)));
+    QObject::connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+    QObject::connect(&progress, SIGNAL(canceled()), &watcher, SLOT(cancel()));
+    watcher.setFuture(QtConcurrent::map(resources, boost::bind(ReformatOneResource, _1, clean_func, &original_texts, &original_texts_mutex)));
+
+    if (!watcher.isFinished()) {
+        loop.exec();
     }
+
+    // Files already being cleaned when cancel was hit still finish.
+    watcher.waitForFinished();
+
+    if (!watcher.isCanceled()) {
+        return true;
+    }
+
+    // Cancelled, so put back anything that was changed
+    QHashIterator<HTMLResource *, QString> it(original_texts);
+
+    while (it.hasNext()) {
+        it.next();
+        QWriteLocker locker(&it.key()->GetLock());
+        it.key()->SetText(it.value());
+    }
+
+    return false;
+}
+
+
+void CleanSource::ReformatOneResource(HTMLResource *resource,
+                                      QString(clean_func)(const QString &source),
+                                      QHash<HTMLResource *, QString> *original_texts,
+                                      QMutex *original_texts_mutex)
+{
+    QWriteLocker locker(&resource->GetLock());
+    const QString &original_text = resource->GetText();
+    const QString &new_text = clean_func(original_text);
+
+    if (new_text == original_text) {
+        return;
+    }
+
+    {
+        QMutexLocker original_texts_locker(original_texts_mutex);
+        original_texts->insert(resource, original_text);
+    }
+    resource->SetText(new_text);
+}
 }
 
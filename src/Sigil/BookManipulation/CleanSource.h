@@ -26,12 +26,14 @@
 #include <boost/tuple/tuple.hpp>
 #include <tidy.h>
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
 
 #include "ResourceObjects/HTMLResource.h"
 
 using boost::tuple;
 
+class QMutex;
 class QStringList;
 
 class CleanSource
@@ -57,7 +59,19 @@ public:
 
     static QString NbspToEntity(const QString &source);
 
-    static void ReformatAll(QList <HTMLResource *> resources, QString(clean_fun)(const QString &source));
+    /**
+     * Cleans all the given resources in parallel, showing a cancellable
+     * progress dialog. On cancel, the resources already cleaned are
+     * restored to their original text.
+     *
+     * @param show_progress If \c false, no dialog is shown and the
+     *                      operation cannot be cancelled; for runs
+     *                      without the main window.
+     * @return \c false if the user cancelled the operation.
+     */
+    static bool ReformatAll(QList <HTMLResource *> resources,
+                            QString(clean_fun)(const QString &source),
+                            bool show_progress = true);
 
 private:
 
@@ -72,6 +86,15 @@ private:
     static QString PrettyPrint(const QString &source);
     static QString PrettyPrintTidy(const QString &source);
 
+    /**
+     * Cleans one resource for ReformatAll. If the text changes, the original
+     * is stored in original_texts so it can be rolled back on cancel.
+     */
+    static void ReformatOneResource(HTMLResource *resource,
+                                    QString(clean_func)(const QString &source),
+                                    QHash<HTMLResource *, QString> *original_texts,
+                                    QMutex *original_texts_mutex);
+
     static int RobustCSSStyleTagCount(const QString &source);
 
     // Cleans CSS; currently it removes the redundant CSS classes
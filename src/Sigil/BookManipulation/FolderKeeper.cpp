@@ -22,9 +22,11 @@
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QThread>
 #include <QtCore/QTime>
+#include <QtConcurrent/QtConcurrent>
 #include <QtWidgets/QApplication>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
@@ -124,71 +126,138 @@ Resource &FolderKeeper::AddContentFileToFolder(const QString &fullfilepath, bool
         boost_throw(FileDoesNotExist() << errinfo_file_name(fullfilepath.toStdString()));
     }
 
-    QString new_file_path;
-    QString normalised_file_path = fullfilepath;
     Resource *resource = NULL;
-    // Rename files that start with a '.'
-    // These merely introduce needless difficulties
-    QFileInfo fileInformation(normalised_file_path);
-    QString fileName = fileInformation.fileName();
-
-    if (fileName.left(1) == ".") {
-        normalised_file_path = fileInformation.canonicalPath() % "/" % fileName.right(fileName.size() - 1);
-    }
-
     // We need to lock here because otherwise
     // several threads can get the same "unique" name.
     // After we deal with the resource hash, other threads can continue.
     {
         QMutexLocker locker(&m_AccessMutex);
-        QString filename  = GetUniqueFilenameVersion(QFileInfo(normalised_file_path).fileName());
-        QString extension = QFileInfo(normalised_file_path).suffix().toLower();
-
-        if (fullfilepath.contains(FILE_EXCEPTIONS)) {
-            if (filename == "page-map.xml") {
-                new_file_path = m_FullPathToMiscFolder + "/" + filename;
-                resource = new MiscTextResource(m_FullPathToMainFolder, new_file_path);
-            } else {
-                // This is a big hack that assumes the new and old filepaths use root paths
-                // of the same length. I can't see how to fix this without refactoring
-                // a lot of the code to provide a more generalised interface.
-                new_file_path = m_FullPathToMainFolder % fullfilepath.right(fullfilepath.size() - m_FullPathToMainFolder.size());
-                resource = new Resource(m_FullPathToMainFolder, new_file_path);
+        QString filename = GetUniqueFilenameVersion(NormalisedFilename(fullfilepath));
+        resource = CreateResource(fullfilepath, filename, mimetype);
+        m_Resources[ resource->GetIdentifier() ] = resource;
+    }
+    QFile::copy(fullfilepath, resource->GetFullPath());
+    ConnectAddedResource(resource);
+
+    if (update_opf) {
+        emit ResourceAdded(*resource);
+    }
+
+    return *resource;
+}
+
+
+QList< Resource * > FolderKeeper::AddContentFilesToFolder(const QStringList &fullfilepaths, bool update_opf)
+{
+    foreach(QString fullfilepath, fullfilepaths) {
+        if (!QFileInfo(fullfilepath).exists()) {
+            boost_throw(FileDoesNotExist() << errinfo_file_name(fullfilepath.toStdString()));
+        }
+    }
+
+    QList< Resource * > resources;
+    QList< FileCopy > copies;
+    {
+        QMutexLocker locker(&m_AccessMutex);
+        // Every name is resolved against the same list, which grows
+        // as we go, so files in the batch never collide with each other.
+        QStringList filenames = GetAllFilenames();
+        QSet< QString > taken_filenames = filenames.toSet();
+        foreach(QString fullfilepath, fullfilepaths) {
+            QString filename = NormalisedFilename(fullfilepath);
+
+            if (taken_filenames.contains(filename)) {
+                filename = GetUniqueFilenameVersion(filename, filenames);
             }
-        } else if (MISC_TEXT_EXTENSIONS.contains(extension)) {
+
+            filenames.append(filename);
+            taken_filenames.insert(filename);
+            Resource *resource = CreateResource(fullfilepath, filename);
+            m_Resources[ resource->GetIdentifier() ] = resource;
+            resources.append(resource);
+            copies.append(FileCopy(fullfilepath, resource->GetFullPath()));
+        }
+    }
+    QtConcurrent::blockingMap(copies, CopyResourceFile);
+    foreach(Resource * resource, resources) {
+        ConnectAddedResource(resource);
+    }
+
+    if (update_opf && !resources.isEmpty()) {
+        m_OPF->AddResources(resources);
+    }
+
+    return resources;
+}
+
+
+QString FolderKeeper::NormalisedFilename(const QString &fullfilepath)
+{
+    // Rename files that start with a '.'
+    // These merely introduce needless difficulties
+    QString filename = QFileInfo(fullfilepath).fileName();
+
+    if (filename.left(1) == ".") {
+        filename = filename.right(filename.size() - 1);
+    }
+
+    return filename;
+}
+
+
+Resource *FolderKeeper::CreateResource(const QString &fullfilepath, const QString &filename, const QString &mimetype)
+{
+    QString new_file_path;
+    Resource *resource = NULL;
+    QString extension = QFileInfo(filename).suffix().toLower();
+
+    if (fullfilepath.contains(FILE_EXCEPTIONS)) {
+        if (filename == "page-map.xml") {
             new_file_path = m_FullPathToMiscFolder + "/" + filename;
             resource = new MiscTextResource(m_FullPathToMainFolder, new_file_path);
-        } else if (AUDIO_EXTENSIONS.contains(extension) || AUDIO_MIMETYPES.contains(mimetype)) {
-            new_file_path = m_FullPathToAudioFolder + "/" + filename;
-            resource = new AudioResource(m_FullPathToMainFolder, new_file_path);
-        } else if (VIDEO_EXTENSIONS.contains(extension) || VIDEO_MIMETYPES.contains(mimetype)) {
-            new_file_path = m_FullPathToVideoFolder + "/" + filename;
-            resource = new VideoResource(m_FullPathToMainFolder, new_file_path);
-        } else if (IMAGE_EXTENSIONS.contains(extension) || IMAGE_MIMEYPES.contains(mimetype)) {
-            new_file_path = m_FullPathToImagesFolder + "/" + filename;
-            resource = new ImageResource(m_FullPathToMainFolder, new_file_path);
-        } else if (SVG_EXTENSIONS.contains(extension) || SVG_MIMETYPES.contains(mimetype)) {
-            new_file_path = m_FullPathToImagesFolder + "/" + filename;
-            resource = new SVGResource(m_FullPathToMainFolder, new_file_path);
-        } else if (FONT_EXTENSIONS.contains(extension)) {
-            new_file_path = m_FullPathToFontsFolder + "/" + filename;
-            resource = new FontResource(m_FullPathToMainFolder, new_file_path);
-        } else if (TEXT_EXTENSIONS.contains(extension) || TEXT_MIMETYPES.contains(mimetype)) {
-            new_file_path = m_FullPathToTextFolder + "/" + filename;
-            resource = new HTMLResource(m_FullPathToMainFolder, new_file_path, m_Resources);
-        } else if (STYLE_EXTENSIONS.contains(extension) || STYLE_MIMETYPES.contains(mimetype)) {
-            new_file_path = m_FullPathToStylesFolder + "/" + filename;
-            resource = new CSSResource(m_FullPathToMainFolder, new_file_path);
         } else {
-            // Fallback mechanism
-            new_file_path = m_FullPathToMiscFolder + "/" + filename;
+            // This is a big hack that assumes the new and old filepaths use root paths
+            // of the same length. I can't see how to fix this without refactoring
+            // a lot of the code to provide a more generalised interface.
+            new_file_path = m_FullPathToMainFolder % fullfilepath.right(fullfilepath.size() - m_FullPathToMainFolder.size());
             resource = new Resource(m_FullPathToMainFolder, new_file_path);
         }
-
-        m_Resources[ resource->GetIdentifier() ] = resource;
+    } else if (MISC_TEXT_EXTENSIONS.contains(extension)) {
+        new_file_path = m_FullPathToMiscFolder + "/" + filename;
+        resource = new MiscTextResource(m_FullPathToMainFolder, new_file_path);
+    } else if (AUDIO_EXTENSIONS.contains(extension) || AUDIO_MIMETYPES.contains(mimetype)) {
+        new_file_path = m_FullPathToAudioFolder + "/" + filename;
+        resource = new AudioResource(m_FullPathToMainFolder, new_file_path);
+    } else if (VIDEO_EXTENSIONS.contains(extension) || VIDEO_MIMETYPES.contains(mimetype)) {
+        new_file_path = m_FullPathToVideoFolder + "/" + filename;
+        resource = new VideoResource(m_FullPathToMainFolder, new_file_path);
+    } else if (IMAGE_EXTENSIONS.contains(extension) || IMAGE_MIMEYPES.contains(mimetype)) {
+        new_file_path = m_FullPathToImagesFolder + "/" + filename;
+        resource = new ImageResource(m_FullPathToMainFolder, new_file_path);
+    } else if (SVG_EXTENSIONS.contains(extension) || SVG_MIMETYPES.contains(mimetype)) {
+        new_file_path = m_FullPathToImagesFolder + "/" + filename;
+        resource = new SVGResource(m_FullPathToMainFolder, new_file_path);
+    } else if (FONT_EXTENSIONS.contains(extension)) {
+        new_file_path = m_FullPathToFontsFolder + "/" + filename;
+        resource = new FontResource(m_FullPathToMainFolder, new_file_path);
+    } else if (TEXT_EXTENSIONS.contains(extension) || TEXT_MIMETYPES.contains(mimetype)) {
+        new_file_path = m_FullPathToTextFolder + "/" + filename;
+        resource = new HTMLResource(m_FullPathToMainFolder, new_file_path, m_Resources);
+    } else if (STYLE_EXTENSIONS.contains(extension) || STYLE_MIMETYPES.contains(mimetype)) {
+        new_file_path = m_FullPathToStylesFolder + "/" + filename;
+        resource = new CSSResource(m_FullPathToMainFolder, new_file_path);
+    } else {
+        // Fallback mechanism
+        new_file_path = m_FullPathToMiscFolder + "/" + filename;
+        resource = new Resource(m_FullPathToMainFolder, new_file_path);
     }
-    QFile::copy(fullfilepath, new_file_path);
 
+    return resource;
+}
+
+
+void FolderKeeper::ConnectAddedResource(Resource *resource)
+{
     if (QThread::currentThread() != QApplication::instance()->thread()) {
         resource->moveToThread(QApplication::instance()->thread());
     }
@@ -197,12 +266,12 @@ Resource &FolderKeeper::AddContentFileToFolder(const QString &fullfilepath, bool
             this,     SLOT(RemoveResource(const Resource &)), Qt::DirectConnection);
     connect(resource, SIGNAL(Renamed(const Resource &, QString)),
             this,     SLOT(ResourceRenamed(const Resource &, QString)), Qt::DirectConnection);
+}
 
-    if (update_opf) {
-        emit ResourceAdded(*resource);
-    }
 
-    return *resource;
+void FolderKeeper::CopyResourceFile(const FileCopy &copy)
+{
+    QFile::copy(copy.first, copy.second);
 }
 
 
@@ -220,8 +289,12 @@ int FolderKeeper::GetHighestReadingOrder() const
 
 QString FolderKeeper::GetUniqueFilenameVersion(const QString &filename) const
 {
-    const QStringList &filenames = GetAllFilenames();
+    return GetUniqueFilenameVersion(filename, GetAllFilenames());
+}
 
+
+QString FolderKeeper::GetUniqueFilenameVersion(const QString &filename, const QStringList &filenames)
+{
     if (!filenames.contains(filename)) {
         return filename;
     }
@@ -28,6 +28,7 @@
 #include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QMutex>
+#include <QtCore/QPair>
 #include <QFileSystemWatcher>
 
 // These have to be included directly because
@@ -87,6 +88,20 @@ public:
                                      bool update_opf = true,
                                      const QString &mimetype = QString());
 
+    /**
+     * Adds several content files to the book folder in one go and
+     * returns the corresponding Resource objects, in the same order.
+     * Unique names are resolved in a single pass, the files are
+     * copied in parallel and the OPF is updated only once.
+     *
+     * @param fullfilepaths The full paths to the files to add.
+     * @param update_opf If set to \c true, then the OPF will be notified
+     *                   that the files were added.
+     * @return The newly created resources.
+     */
+    QList< Resource * > AddContentFilesToFolder(const QStringList &fullfilepaths,
+            bool update_opf = true);
+
     /**
      * Returns the highest reading order number present in the book.
      *
@@ -279,6 +294,42 @@ private:
      */
     void CreateInfrastructureFiles();
 
+    /**
+     * A source and destination path pair for a file copy.
+     */
+    typedef QPair< QString, QString > FileCopy;
+
+    /**
+     * Returns the name a file should get in the book,
+     * before it is made unique.
+     *
+     * @param fullfilepath The full path to the file being added.
+     * @return The filename.
+     */
+    static QString NormalisedFilename(const QString &fullfilepath);
+
+    /**
+     * Returns a unique version of the filename with respect
+     * to the provided list of existing filenames.
+     */
+    static QString GetUniqueFilenameVersion(const QString &filename, const QStringList &filenames);
+
+    /**
+     * Creates the resource of the appropriate type for the file,
+     * placed in the matching folder under the given name.
+     * The file itself is not copied.
+     */
+    Resource *CreateResource(const QString &fullfilepath,
+                             const QString &filename,
+                             const QString &mimetype = QString());
+
+    /**
+     * Hooks up a freshly added resource to the FolderKeeper.
+     */
+    void ConnectAddedResource(Resource *resource);
+
+    static void CopyResourceFile(const FileCopy &copy);
+
     /**
      * Dereferences two pointers and compares the values with "<".
      *
@@ -48,25 +48,93 @@ const QStringList HEADING_TAGS = QStringList() << "h1" << "h2" << "h3" << "h4" <
 const QString SIGIL_NOT_IN_TOC_CLASS = "sigil_not_in_toc";
 const QString OLD_SIGIL_NOT_IN_TOC_CLASS = "sigilNotInTOC";
 
+QHash< QString, Headings::FileHeadings > Headings::m_HeadingCache;
+QMutex Headings::m_HeadingCacheMutex;
+
 
 // Returns a list of headings from the provided XHTML source;
 // the list is flat, the headings are *not* in a hierarchy tree
 QList< Headings::Heading > Headings::GetHeadingList(QList< HTMLResource * > html_resources,
         bool include_unwanted_headings)
 {
-    QList< Headings::Heading > heading_list;
+    QMutexLocker locker(&m_HeadingCacheMutex);
+    QList< HTMLResource * > modified_resources;
+    QList< int > revisions;
+    QSet< QString > identifiers;
+    foreach(HTMLResource * html_resource, html_resources) {
+        const QString &identifier = html_resource->GetIdentifier();
+        // Read before parsing, so a change made in the
+        // meantime makes the headings look out of date
+        int revision = html_resource->GetRevision();
+        identifiers.insert(identifier);
+
+        if (!m_HeadingCache.contains(identifier) || m_HeadingCache.value(identifier).revision != revision) {
+            modified_resources.append(html_resource);
+            revisions.append(revision);
+        }
+    }
+    foreach(QString identifier, m_HeadingCache.keys()) {
+        if (!identifiers.contains(identifier)) {
+            m_HeadingCache.remove(identifier);
+        }
+    }
     QList< QList< Headings::Heading > > per_file_headings =
-        QtConcurrent::blockingMapped(html_resources,
-                                     boost::bind(GetHeadingListForOneFile, _1, include_unwanted_headings));
+        QtConcurrent::blockingMapped(modified_resources,
+                                     boost::bind(GetHeadingListForOneFile, _1, true));
 
     for (int i = 0; i < per_file_headings.count(); ++i) {
-        heading_list.append(per_file_headings.at(i));
+        FileHeadings file_headings;
+        file_headings.revision = revisions.at(i);
+        file_headings.headings = per_file_headings.at(i);
+
+        // Keeping the DOM of every file alive for the whole session would
+        // cost far more memory than parsing a file again when it's edited
+        for (int j = 0; j < file_headings.headings.count(); ++j) {
+            file_headings.headings[ j ].document.reset();
+            file_headings.headings[ j ].element = NULL;
+        }
+
+        m_HeadingCache[ modified_resources.at(i)->GetIdentifier() ] = file_headings;
     }
 
+    QList< Headings::Heading > heading_list;
+    foreach(HTMLResource * html_resource, html_resources) {
+        foreach(const Heading & heading, m_HeadingCache.value(html_resource->GetIdentifier()).headings) {
+            if (heading.include_in_toc || include_unwanted_headings) {
+                heading_list.append(heading);
+            }
+        }
+    }
     return heading_list;
 }
 
 
+void Headings::DetachDocument(QList< Heading > &headings, HTMLResource *html_resource)
+{
+    shared_ptr<xc::DOMDocument> document = XhtmlDoc::LoadTextIntoDocument(html_resource->GetText());
+    SetDocument(headings, html_resource, document,
+                XhtmlDoc::GetTagMatchingDescendants(*document.get(), HEADING_TAGS));
+}
+
+
+void Headings::SetDocument(QList< Heading > &headings,
+                           HTMLResource *html_resource,
+                           shared_ptr<xc::DOMDocument> document,
+                           const QList< xc::DOMElement * > &heading_nodes)
+{
+    for (int i = 0; i < headings.count(); ++i) {
+        Heading &heading = headings[ i ];
+
+        if (heading.resource_file == html_resource) {
+            heading.document = document;
+            heading.element  = heading_nodes.value(heading.element_index);
+        }
+
+        SetDocument(heading.children, html_resource, document, heading_nodes);
+    }
+}
+
+
 QList< Headings::Heading > Headings::GetHeadingListForOneFile(HTMLResource *html_resource,
         bool include_unwanted_headings)
 {
@@ -96,18 +164,23 @@ QList< Headings::Heading > Headings::GetHeadingListForOneFile(HTMLResource *html
         heading.resource_file  = html_resource;
         heading.document       = d;
         heading.element        = &element;
+        heading.element_index  = i;
         heading.title          = element.hasAttribute(QtoX("title"))
                                  ? XtoQ(element.getAttribute(QtoX("title"))).simplified()
                                  : QString();
         heading.orig_title     = heading.title;
+        heading.id             = element.hasAttribute(QtoX("id"))
+                                 ? XtoQ(element.getAttribute(QtoX("id")))
+                                 : QString();
+        heading.classes        = XtoQ(element.getAttribute(QtoX("class")));
+        heading.source         = XhtmlDoc::GetDomNodeAsString(element);
         heading.text           = !heading.title.isNull() ?
                                  heading.title :
                                  XtoQ(element.getTextContent()).simplified();
         heading.level          = QString(XtoQ(element.getTagName()).at(1)).toInt();
         heading.orig_level     = heading.level;
-        QString classes        = XtoQ(element.getAttribute(QtoX("class")));
-        heading.include_in_toc = !(classes.contains(SIGIL_NOT_IN_TOC_CLASS) ||
-                                   classes.contains(OLD_SIGIL_NOT_IN_TOC_CLASS));
+        heading.include_in_toc = !(heading.classes.contains(SIGIL_NOT_IN_TOC_CLASS) ||
+                                   heading.classes.contains(OLD_SIGIL_NOT_IN_TOC_CLASS));
         heading.at_file_start  =
             i == 0 &&
             XhtmlDoc::NodeLineNumber(element) -
@@ -25,8 +25,10 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QMetaType>
+#include <QtCore/QMutex>
 
 #include "BookManipulation/XercesHUse.h"
 
@@ -46,11 +48,15 @@ public:
         // The HTMLResource file the heading belongs to
         HTMLResource *resource_file;
 
+        // The parsed file and the heading element in it. Headings from
+        // GetHeadingList don't have these until DetachDocument is called.
         shared_ptr<xc::DOMDocument> document;
-
-        // The DomElement of the heading in the file's DomDocument
         xc::DOMElement *element;
 
+        // The position of the element among the heading
+        // elements of the file, in document order
+        int element_index;
+
         // Represents what the heading should
         // look like in the TOC.
         QString text;
@@ -59,6 +65,13 @@ public:
         QString title;
         QString orig_title;
 
+        // The id and class attributes of the element, if any
+        QString id;
+        QString classes;
+
+        // The markup of the heading element
+        QString source;
+
         // The level of the heading, from 1 to 6
         // (lower number means 'bigger' heading )
         int level;
@@ -93,9 +106,19 @@ public:
     // the list is flat, the headings are *not* in a hierarchy tree.
     // Set include_unwanted_headings to true to get headings that the
     // user has marked as unwanted.
+    // The headings of each file are cached until the file changes.
+    // The cache only keeps the plain heading data, so the headings
+    // returned have no DOM document: call DetachDocument to get one
+    // before modifying them. Files not in html_resources are dropped
+    // from the cache.
     static QList< Heading > GetHeadingList(QList< HTMLResource * > html_resources,
                                            bool include_unwanted_headings = false);
 
+    // Parses html_resource and points its headings in the (possibly
+    // hierarchical) list at the elements of the new DOM document,
+    // so they can be modified.
+    static void DetachDocument(QList< Heading > &headings, HTMLResource *html_resource);
+
     static QList< Heading > GetHeadingListForOneFile(HTMLResource *html_resource,
             bool include_unwanted_headings = false);
 
@@ -107,6 +130,22 @@ public:
     static QList< Heading > GetFlattenedHeadings(const QList< Heading > &headings);
 
 private:
+    // The headings of one file, including the unwanted ones,
+    // without their DOM documents
+    struct FileHeadings {
+        // The revision of the resource text the headings were taken from
+        int revision;
+
+        QList< Heading > headings;
+    };
+
+    // Points the headings of html_resource in the list, and in their
+    // children, at the elements of the given document
+    static void SetDocument(QList< Heading > &headings,
+                            HTMLResource *html_resource,
+                            shared_ptr<xc::DOMDocument> document,
+                            const QList< xc::DOMElement * > &heading_nodes);
+
     // Flattens the provided heading node and its children
     // into a list and returns it
     static QList< Heading > FlattenHeadingNode(Heading heading);
@@ -114,6 +153,10 @@ private:
     // Adds the new_child heading to the parent heading;
     // the new_child is propagated down the tree if necessary
     static void AddChildHeading(Heading &parent, Heading new_child);
+
+    // The headings of every file, keyed on the resource identifier
+    static QHash< QString, FileHeadings > m_HeadingCache;
+    static QMutex m_HeadingCacheMutex;
 };
 
 
@@ -20,6 +20,7 @@
 **
 *************************************************************************/
 
+#include <boost/bind/bind.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include <QtCore/QtCore>
@@ -45,28 +46,73 @@ const QString SIGIL_INDEX_ID_PREFIX = "sigil_index_id_";
 bool Index::BuildIndex(QList<HTMLResource *> html_resources)
 {
     IndexEntries::instance()->Clear();
+    // The Index Editor model lives in the GUI thread, so read
+    // and compile its patterns here, once, for all the files.
+    const QList<IndexPattern> patterns = CompileIndexPatterns();
     // Display progress dialog
     QProgressDialog progress(QObject::tr("Creating Index..."), QObject::tr("Cancel"), 0, html_resources.count(), QApplication::activeWindow());
     progress.setMinimumDuration(0);
-    int progress_value = 0;
-    progress.setValue(progress_value);
-    qApp->processEvents();
-    // Must do sequentially in order to keep sections in order
-    foreach(HTMLResource * html_resource, html_resources) {
-        // Set progress value and ensure dialog has time to display when doing extensive updates
-        if (progress.wasCanceled()) {
-            return false;
-        }
+    progress.setValue(0);
+    // Each file is independent, so they are matched in parallel
+    QFutureWatcher< QList<IndexHit> > watcher;
+    QEventLoop loop;
+    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)), &progress, SLOT(setValue(int)));
+    QObject::connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+    QObject::connect(&progress, SIGNAL(canceled()), &watcher, SLOT(cancel()));
+    watcher.setFuture(QtConcurrent::mapped(html_resources, boost::bind(AddIndexIDsOneFile, _1, patterns)));
+
+    if (!watcher.isFinished()) {
+        loop.exec();
+    }
 
-        progress.setValue(progress_value++);
-        qApp->processEvents();
-        AddIndexIDsOneFile(html_resource);
+    watcher.waitForFinished();
+
+    if (watcher.isCanceled()) {
+        return false;
+    }
+
+    // Merge the hits in reading order, so sections are kept in order
+    // however the work was scheduled.
+    for (int i = 0; i < html_resources.count(); i++) {
+        const QString filename = html_resources.at(i)->Filename();
+        foreach(const IndexHit & hit, watcher.resultAt(i)) {
+            IndexEntries::instance()->AddOneEntry(hit.first, filename, hit.second);
+        }
     }
     return true;
 }
 
-void Index::AddIndexIDsOneFile(HTMLResource *html_resource)
+QList<Index::IndexPattern> Index::CompileIndexPatterns()
+{
+    QList<IndexPattern> patterns;
+    QList<IndexEditorModel::indexEntry *> entries = IndexEditorModel::instance()->GetEntries();
+    foreach(IndexEditorModel::indexEntry * entry, entries) {
+        IndexPattern pattern;
+        pattern.pattern = entry->pattern;
+        pattern.index_entry = entry->index_entry;
+        delete entry;
+
+        if (pattern.pattern.isEmpty()) {
+            continue;
+        }
+
+        pattern.regex.setPattern(pattern.pattern);
+
+        // isValid() also compiles the pattern, so the worker
+        // threads only ever match against a compiled expression.
+        // An invalid pattern can never match, so drop it here.
+        if (!pattern.regex.isValid()) {
+            continue;
+        }
+
+        patterns.append(pattern);
+    }
+    return patterns;
+}
+
+QList<Index::IndexHit> Index::AddIndexIDsOneFile(HTMLResource *html_resource, const QList<IndexPattern> &patterns)
 {
+    QList<IndexHit> hits;
     QWriteLocker locker(&html_resource->GetLock());
     shared_ptr<xc::DOMDocument> d = XhtmlDoc::LoadTextIntoDocument(html_resource->GetText());
     QList< xc::DOMNode * > nodes = XhtmlDoc::GetIDNodes(*d.get());
@@ -113,11 +159,11 @@ void Index::AddIndexIDsOneFile(HTMLResource *html_resource)
 
         // Use the existing id if there is one, else add one if node contains index item
         if (element.hasAttribute(QtoX("id"))) {
-            CreateIndexEntry(text_node_text, html_resource, index_id_value, is_custom_index_entry, custom_index_value);
+            CreateIndexEntry(text_node_text, index_id_value, is_custom_index_entry, custom_index_value, patterns, hits);
         } else {
             index_id_value = SIGIL_INDEX_ID_PREFIX + QString::number(index_id_number);
 
-            if (CreateIndexEntry(text_node_text, html_resource, index_id_value, is_custom_index_entry, custom_index_value)) {
+            if (CreateIndexEntry(text_node_text, index_id_value, is_custom_index_entry, custom_index_value, patterns, hits)) {
                 element.setAttribute(QtoX("id"), QtoX(index_id_value));
                 resource_updated = true;
                 index_id_number++;
@@ -128,44 +174,53 @@ void Index::AddIndexIDsOneFile(HTMLResource *html_resource)
     if (resource_updated) {
         html_resource->SetText(XhtmlDoc::GetDomDocumentAsString(*d.get()));
     }
+
+    return hits;
 }
 
-bool Index::CreateIndexEntry(const QString text, HTMLResource *html_resource, QString index_id_value, bool is_custom_index_entry, QString custom_index_value)
+bool Index::CreateIndexEntry(const QString &text,
+                             const QString &index_id_value,
+                             bool is_custom_index_entry,
+                             const QString &custom_index_value,
+                             const QList<IndexPattern> &patterns,
+                             QList<IndexHit> &hits)
 {
-    bool created_index = false;
-    QList<IndexEditorModel::indexEntry *> entries;
-
     if (is_custom_index_entry) {
-        IndexEditorModel::indexEntry *custom_entry = new IndexEditorModel::indexEntry();
-        custom_entry->pattern = text;
-        custom_entry->index_entry = custom_index_value;
-        entries.append(custom_entry);
-    } else {
-        entries = IndexEditorModel::instance()->GetEntries();
-    }
+        IndexPattern custom_pattern;
+        custom_pattern.pattern = text;
+        custom_pattern.index_entry = custom_index_value;
+        custom_pattern.regex.setPattern(text);
 
-    foreach(IndexEditorModel::indexEntry * entry, entries) {
-        QString index_pattern = entry->pattern;
-        if (index_pattern.isEmpty()) {
-            continue;
+        if (text.isEmpty() || !text.contains(custom_pattern.regex)) {
+            return false;
         }
 
-        QRegularExpression index_regex(index_pattern);
+        AddHitForPattern(custom_pattern, index_id_value, hits);
+        return true;
+    }
 
-        if (text.contains(index_regex)) {
+    bool created_index = false;
+    foreach(const IndexPattern & pattern, patterns) {
+        if (text.contains(pattern.regex)) {
             created_index = true;
-            QString index_entry = entry->index_entry;
-            if (index_entry.isEmpty()) {
-                // If no index text, use the pattern
-                IndexEntries::instance()->AddOneEntry(index_pattern, html_resource->Filename(), index_id_value);
-            } else if (entry->index_entry.endsWith("/")) {
-                // If index text is a category then append the pattern
-                IndexEntries::instance()->AddOneEntry(index_entry + index_pattern, html_resource->Filename(), index_id_value);
-            } else {
-                // Use the given index text
-                IndexEntries::instance()->AddOneEntry(index_entry, html_resource->Filename(), index_id_value);
-            }
+            AddHitForPattern(pattern, index_id_value, hits);
         }
     }
     return created_index;
 }
+
+void Index::AddHitForPattern(const IndexPattern &pattern, const QString &index_id_value, QList<IndexHit> &hits)
+{
+    const QString &index_entry = pattern.index_entry;
+
+    if (index_entry.isEmpty()) {
+        // If no index text, use the pattern
+        hits.append(IndexHit(pattern.pattern, index_id_value));
+    } else if (index_entry.endsWith("/")) {
+        // If index text is a category then append the pattern
+        hits.append(IndexHit(index_entry + pattern.pattern, index_id_value));
+    } else {
+        // Use the given index text
+        hits.append(IndexHit(index_entry, index_id_value));
+    }
+}
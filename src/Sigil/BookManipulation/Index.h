@@ -24,6 +24,11 @@
 #ifndef INDEX_H
 #define INDEX_H
 
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QRegularExpression>
+
 class HTMLResource;
 
 /**
@@ -38,9 +43,32 @@ public:
     static bool BuildIndex(QList<HTMLResource *> html_resources);
 
 private:
-    static void AddIndexIDsOneFile(HTMLResource *html_resource);
+    /**
+     * An Index Editor entry with its pattern compiled once per index build.
+     */
+    struct IndexPattern {
+        QString pattern;
+        QString index_entry;
+        QRegularExpression regex;
+    };
+
+    /**
+     * One match found in a file: the index entry text and the id it targets.
+     */
+    typedef QPair<QString, QString> IndexHit;
+
+    static QList<IndexPattern> CompileIndexPatterns();
+
+    static QList<IndexHit> AddIndexIDsOneFile(HTMLResource *html_resource, const QList<IndexPattern> &patterns);
+
+    static bool CreateIndexEntry(const QString &text,
+                                 const QString &index_id_value,
+                                 bool is_custom_index_entry,
+                                 const QString &custom_index_value,
+                                 const QList<IndexPattern> &patterns,
+                                 QList<IndexHit> &hits);
 
-    static bool CreateIndexEntry(const QString text, HTMLResource *html_resource, QString index_id_name, bool is_custom_index_entry, QString custom_index_name);
+    static void AddHitForPattern(const IndexPattern &pattern, const QString &index_id_value, QList<IndexHit> &hits);
 };
 
 #endif // INDEX_H
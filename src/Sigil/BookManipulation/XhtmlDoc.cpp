@@ -22,7 +22,6 @@
 *************************************************************************/
 
 #include <boost/bind/bind.hpp>
-#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/sax2/SAX2XMLReader.hpp>
@@ -36,6 +35,7 @@
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QMutex>
 #include <QtCore/QString>
 #include <QtCore/QXmlStreamReader>
 #include <QtWebKitWidgets/QWebFrame>
@@ -483,9 +483,24 @@ int XhtmlDoc::NodeColumnNumber(const xc::DOMNode &node)
 }
 
 
-XhtmlDoc::WellFormedError XhtmlDoc::WellFormedErrorForSource(const QString &source)
+// SAX readers that have already been configured and have the DTD grammars
+// loaded. Creating a reader and parsing the grammars costs more than the
+// well-formed check of a typical file, so readers are reused. A reader is
+// only ever used by one thread at a time, but any thread can take one.
+static QList< xc::SAX2XMLReader * > s_WellFormedReaderPool;
+static QMutex s_WellFormedReaderPoolMutex;
+
+static xc::SAX2XMLReader *AcquireWellFormedReader()
 {
-    boost::scoped_ptr< xc::SAX2XMLReader > parser(xc::XMLReaderFactory::createXMLReader());
+    {
+        QMutexLocker locker(&s_WellFormedReaderPoolMutex);
+
+        if (!s_WellFormedReaderPool.isEmpty()) {
+            return s_WellFormedReaderPool.takeLast();
+        }
+    }
+
+    xc::SAX2XMLReader *parser = xc::XMLReaderFactory::createXMLReader();
     parser->setFeature(xc::XMLUni::fgSAX2CoreValidation,            false);
     parser->setFeature(xc::XMLUni::fgXercesSchema,                  false);
     parser->setFeature(xc::XMLUni::fgXercesLoadSchema,              false);
@@ -498,6 +513,22 @@ XhtmlDoc::WellFormedError XhtmlDoc::WellFormedErrorForSource(const QString &sour
     parser->loadGrammar(xhtml_dtd, xc::Grammar::DTDGrammarType, true);
     xc::MemBufInputSource ncx_dtd(fc::NCX_2005_1_DTD, fc::NCX_2005_1_DTD_LEN, fc::NCX_2005_1_DTD_ID);
     parser->loadGrammar(ncx_dtd, xc::Grammar::DTDGrammarType, true);
+    return parser;
+}
+
+
+static void ReleaseWellFormedReader(xc::SAX2XMLReader *parser)
+{
+    // The error handler lives on the stack of the caller
+    parser->setErrorHandler(NULL);
+    QMutexLocker locker(&s_WellFormedReaderPoolMutex);
+    s_WellFormedReaderPool.append(parser);
+}
+
+
+XhtmlDoc::WellFormedError XhtmlDoc::WellFormedErrorForSource(const QString &source)
+{
+    xc::SAX2XMLReader *parser = AcquireWellFormedReader();
     fc::ErrorResultCollector collector;
     parser->setErrorHandler(&collector);
     QString prepared_source = PrepareSourceForXerces(source);
@@ -518,6 +549,7 @@ XhtmlDoc::WellFormedError XhtmlDoc::WellFormedErrorForSource(const QString &sour
         collector.AddNewExceptionAsResult(exception);
     }
 
+    ReleaseWellFormedReader(parser);
     std::vector< fc::Result > results = collector.GetResults();
 
     if (!results.empty()) {
@@ -629,6 +661,20 @@ QList< QWebElement > XhtmlDoc::QWebElementChildren(const QWebElement &element)
 
 QStringList XhtmlDoc::GetSGFSectionSplits(const QString &source,
         const QString &custom_header)
+{
+    const SGFSectionSplits splits = GetSGFSectionSplitOffsets(source, custom_header);
+    QStringList sections;
+
+    for (int i = 0; i < splits.count(); ++i) {
+        sections.append(splits.Section(i));
+    }
+
+    return sections;
+}
+
+
+XhtmlDoc::SGFSectionSplits XhtmlDoc::GetSGFSectionSplitOffsets(const QString &source,
+        const QString &custom_header)
 {
     QRegularExpression body_start_tag(BODY_START);
     QRegularExpressionMatch body_start_tag_match = body_start_tag.match(source);
@@ -637,30 +683,41 @@ QStringList XhtmlDoc::GetSGFSectionSplits(const QString &source,
     int body_end   = source.indexOf(body_end_tag, 0);
     int main_index = body_start_tag_match.capturedEnd();
 
-    QString header = !custom_header.isEmpty() ? custom_header + "<body>\n" : source.left(main_index);
-    QStringList sections;
+    SGFSectionSplits splits;
+    splits.source = source;
+    splits.header = !custom_header.isEmpty() ? custom_header + "<body>\n" : source.left(main_index);
     QRegularExpression break_tag(BREAK_TAG_SEARCH);
 
     while (main_index != body_end) {
         QRegularExpressionMatch match = break_tag.match(source, main_index);
-        QString body;
 
         // We search for our HR break tag
         if (match.hasMatch()) {
             // We break up the remainder of the file on the HR tag index if it's found
             int break_index = match.capturedStart();
-            body = Utility::Substring(main_index, break_index, source);
+            splits.bodies.append(qMakePair(main_index, break_index));
             main_index = break_index + match.capturedLength();
         } else {
             // Otherwise, we take the rest of the file
-            body = Utility::Substring(main_index, body_end, source);
+            splits.bodies.append(qMakePair(main_index, body_end));
             main_index = body_end;
         }
-
-        sections.append(header + body + "</body> </html>");
     }
 
-    return sections;
+    return splits;
+}
+
+
+QString XhtmlDoc::SGFSectionSplits::Section(int index) const
+{
+    static const QString SECTION_END = "</body> </html>";
+    const QPair< int, int > &body = bodies.at(index);
+    QString section;
+    section.reserve(header.length() + body.second - body.first + SECTION_END.length());
+    section.append(header);
+    section.append(Utility::SubstringRef(body.first, body.second, source));
+    section.append(SECTION_END);
+    return section;
 }
 
 
@@ -25,6 +25,9 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QString>
 #include <QtWebKit/QWebElement>
 
 #include "BookManipulation/XercesHUse.h"
@@ -113,6 +116,33 @@ public:
 
     static int NodeColumnNumber(const xc::DOMNode &node);
 
+    /**
+     * The sections of a source split on SGF section breaks.
+     * Each section is stored as offsets into the (implicitly shared)
+     * original source, so nothing is copied until a section is needed.
+     */
+    struct SGFSectionSplits {
+        // The source that was split
+        QString source;
+
+        // The header that every section starts with
+        QString header;
+
+        // The start and end offsets of every section body in source
+        QList< QPair< int, int > > bodies;
+
+        int count() const {
+            return bodies.count();
+        }
+
+        bool isEmpty() const {
+            return bodies.isEmpty();
+        }
+
+        // Builds the full text of one section
+        QString Section(int index) const;
+    };
+
     struct WellFormedError {
         int line;
         int column;
@@ -164,6 +194,18 @@ public:
     static QStringList GetSGFSectionSplits(const QString &source,
                                            const QString &custom_header = QString());
 
+    /**
+     * Finds the SGF section breaks in the provided source without
+     * copying any of the sections.
+     *
+     * @param source The source which we want to split.
+     * @param custom_header An option custom header to be used instead of
+     *                      the one in the current source.
+     * @return The offsets of the split sections.
+     */
+    static SGFSectionSplits GetSGFSectionSplitOffsets(const QString &source,
+                                                      const QString &custom_header = QString());
+
     // Removes all the children of a node
     static void RemoveChildren(xc::DOMNode &node);
 
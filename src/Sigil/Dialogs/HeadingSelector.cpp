@@ -266,7 +266,7 @@ int HeadingSelector::UpdateOneHeadingElement(QStandardItem *item, QStringList us
     if (heading != NULL) {
         // Update heading inclusion: if a heading element
         // has one of the SIGIL_NOT_IN_TOC_CLASS classes, then it's not in the TOC
-        const QString &class_attribute = XtoQ(heading->element->getAttribute(QtoX("class")));
+        const QString class_attribute = heading->classes;
         QString new_class_attribute = QString(class_attribute)
                                       .remove(SIGIL_NOT_IN_TOC_CLASS)
                                       .remove(OLD_SIGIL_NOT_IN_TOC_CLASS)
@@ -279,18 +279,19 @@ int HeadingSelector::UpdateOneHeadingElement(QStandardItem *item, QStringList us
         // Only apply the change if it is different
         if (new_class_attribute != class_attribute) {
             heading->is_changed = true;
+            DetachHeadingDocument(heading);
 
             if (!new_class_attribute.isEmpty()) {
                 heading->element->setAttribute(QtoX("class"), QtoX(new_class_attribute));
             } else {
                 heading->element->removeAttribute(QtoX("class"));
             }
+
+            heading->classes = new_class_attribute;
         }
 
         // Now apply the new id as needed.
-        const QString &existing_id_attribute = heading->element->hasAttribute(QtoX("id"))
-                                               ? XtoQ(heading->element->getAttribute(QtoX("id")))
-                                               : QString();
+        const QString existing_id_attribute = heading->id;
         QString new_id_attribute(existing_id_attribute);
 
         if (!heading->include_in_toc || heading->at_file_start) {
@@ -321,12 +322,15 @@ int HeadingSelector::UpdateOneHeadingElement(QStandardItem *item, QStringList us
         // Only apply the change if it is different
         if (new_id_attribute.trimmed() != existing_id_attribute) {
             heading->is_changed = true;
+            DetachHeadingDocument(heading);
 
             if (!new_id_attribute.isEmpty()) {
                 heading->element->setAttribute(QtoX("id"), QtoX(new_id_attribute));
             } else {
                 heading->element->removeAttribute(QtoX("id"));
             }
+
+            heading->id = new_id_attribute;
         }
     }
 
@@ -339,6 +343,16 @@ int HeadingSelector::UpdateOneHeadingElement(QStandardItem *item, QStringList us
     return next_toc_id;
 }
 
+void HeadingSelector::DetachHeadingDocument(Headings::Heading *heading)
+{
+    if (m_DetachedFiles.contains(heading->resource_file)) {
+        return;
+    }
+
+    Headings::DetachDocument(m_Headings, heading->resource_file);
+    m_DetachedFiles.insert(heading->resource_file);
+}
+
 QStringList HeadingSelector::UpdateOneFile(Headings::Heading &heading, QStringList ids)
 {
     // Only save the document if we have changed the heading
@@ -368,6 +382,7 @@ void HeadingSelector::UpdateOneHeadingTitle(QStandardItem *item, const QString &
         if (title != heading->title) {
             heading->title = title;
             heading->is_changed = true;
+            DetachHeadingDocument(heading);
             heading->element->setAttribute(QtoX("title"), QtoX(title));
         }
     }
@@ -416,9 +431,9 @@ void HeadingSelector::ChangeHeadingLevel(int change_amount)
     // Update whether we have made changes to the document for this heading element
     heading->is_changed = (heading->level != heading->orig_level) || (heading->title != heading->orig_title);
     // Get new tag name
-    QString tag_name = XtoQ(heading->element->getTagName());
     QString new_tag_name = "h" + QString::number(heading->level);
     // Rename in document
+    DetachHeadingDocument(heading);
     heading->element = XhtmlDoc::RenameElementInDocument(*heading->document, *heading->element, new_tag_name);
     // Clear all children information then rebuild hierarchy
     QList< Headings::Heading > flat_headings = Headings::GetFlattenedHeadings(m_Headings);
@@ -575,7 +590,7 @@ void HeadingSelector::InsertHeadingIntoModel(Headings::Heading &heading, QStanda
     wrap.heading = &heading;
     item_heading->setData(QVariant::fromValue(wrap));
     // Apparently using \n in the string means you don't have to replace < with &lt; or > with &gt;
-    QString html = XhtmlDoc::GetDomNodeAsString(*heading.element).remove("xmlns=\"http://www.w3.org/1999/xhtml\"");
+    QString html = QString(heading.source).remove("xmlns=\"http://www.w3.org/1999/xhtml\"");
     item_heading->setToolTip(heading.resource_file->Filename() + ":\n\n" + html);
     QList< QStandardItem * > items;
     items << item_heading << heading_level << heading_included_check;
@@ -24,6 +24,7 @@
 #define HEADINGSELECTOR_H
 
 #include <QtCore/QList>
+#include <QtCore/QSet>
 #include <QtCore/QSharedPointer>
 #include <QtWidgets/QDialog>
 #include <QtGui/QStandardItemModel>
@@ -154,6 +155,10 @@ private:
 
     Headings::Heading *GetItemHeading(const QStandardItem *item);
 
+    // The cached headings carry no DOM document,
+    // so a file is parsed before its first change
+    void DetachHeadingDocument(Headings::Heading *heading);
+
 
     // Get the maximum heading level for all headings
     int GetMaxHeadingLevel(QList< Headings::Heading > flat_headings);
@@ -199,6 +204,9 @@ private:
     // The tree of all the headings in the book
     QList< Headings::Heading > m_Headings;
 
+    // The files whose headings have a private document
+    QSet< HTMLResource * > m_DetachedFiles;
+
     QMenu *m_ContextMenu;
 
     QAction *m_Rename;
@@ -21,7 +21,6 @@
 *************************************************************************/
 
 #include <QtWidgets/QScrollArea>
-#include <QtWidgets/QProgressDialog>
 
 #include "Dialogs/Reports.h"
 #include "Misc/SettingsStore.h"
@@ -66,6 +65,10 @@ Reports::Reports(QWidget *parent)
 
 Reports::~Reports()
 {
+    // The workers read members of the derived widgets,
+    // which are gone by the time ~ReportsWidget runs.
+    WaitForReports();
+
     if (m_AllFilesWidget) {
         delete m_AllFilesWidget;
         m_AllFilesWidget = 0;
@@ -109,39 +112,34 @@ Reports::~Reports()
 
 void Reports::CreateReports(QSharedPointer< Book > book)
 {
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    // Display progress dialog
-    QProgressDialog progress(QObject::tr("Creating reports..."), 0, 0, ui.availableWidgets->count(), this);
-    progress.setMinimumDuration(0);
-    int progress_value = 0;
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    // Populate all of our report widgets
-    m_AllFilesWidget->CreateReport(book);
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    m_HTMLFilesWidget->CreateReport(book);
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    m_LinksWidget->CreateReport(book);
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    m_ImageFilesWidget->CreateReport(book);
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    m_CSSFilesWidget->CreateReport(book);
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    m_ClassesInHTMLFilesWidget->CreateReport(book);
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    m_StylesInCSSFilesWidget->CreateReport(book);
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    m_CharactersInHTMLFilesWidget->CreateReport(book);
-    progress.setValue(progress_value++);
-    qApp->processEvents();
-    QApplication::restoreOverrideCursor();
+    // The report on show is started first so it is ready soonest. It is
+    // filled in when the dialog is shown, the others when they are selected.
+    // They all share one copy of the resources taken here on the GUI thread.
+    ReportsWidget *current_widget = qobject_cast< ReportsWidget * >(ui.pWidget->currentWidget());
+    QList<BookReports::ResourceSnapshot> resources = BookReports::GetResourceSnapshots(book);
+
+    if (current_widget) {
+        current_widget->CreateReport(book, resources);
+    }
+
+    for (int i = 0; i < ui.pWidget->count(); ++i) {
+        ReportsWidget *widget = qobject_cast< ReportsWidget * >(ui.pWidget->widget(i));
+
+        if (widget && widget != current_widget) {
+            widget->CreateReport(book, resources);
+        }
+    }
+}
+
+void Reports::WaitForReports()
+{
+    for (int i = 0; i < ui.pWidget->count(); ++i) {
+        ReportsWidget *widget = qobject_cast< ReportsWidget * >(ui.pWidget->widget(i));
+
+        if (widget) {
+            widget->WaitForReportData();
+        }
+    }
 }
 
 void Reports::selectPWidget(QListWidgetItem *current, QListWidgetItem *previous)
@@ -161,6 +159,24 @@ void Reports::saveSettings()
     QApplication::restoreOverrideCursor();
 }
 
+void Reports::DeleteFiles(QStringList files_to_delete)
+{
+    WaitForReports();
+    emit DeleteFilesRequest(files_to_delete);
+}
+
+void Reports::DeleteStyles(QList<BookReports::StyleData *> styles_to_delete)
+{
+    WaitForReports();
+    emit DeleteStylesRequest(styles_to_delete);
+}
+
+void Reports::RefreshReports()
+{
+    WaitForReports();
+    emit Refresh();
+}
+
 void Reports::readSettings()
 {
     SettingsStore settings;
@@ -195,14 +211,14 @@ void Reports::appendReportsWidget(ReportsWidget *widget)
 
 void Reports::connectSignalsSlots()
 {
-    connect(m_HTMLFilesWidget, SIGNAL(DeleteFilesRequest(QStringList)), this, SIGNAL(DeleteFilesRequest(QStringList)));
-    connect(m_ImageFilesWidget, SIGNAL(DeleteFilesRequest(QStringList)), this, SIGNAL(DeleteFilesRequest(QStringList)));
+    connect(m_HTMLFilesWidget, SIGNAL(DeleteFilesRequest(QStringList)), this, SLOT(DeleteFiles(QStringList)));
+    connect(m_ImageFilesWidget, SIGNAL(DeleteFilesRequest(QStringList)), this, SLOT(DeleteFiles(QStringList)));
     connect(m_ImageFilesWidget, SIGNAL(FindTextInTags(QString)), this, SIGNAL(FindTextInTags(QString)));
-    connect(m_CSSFilesWidget, SIGNAL(DeleteFilesRequest(QStringList)), this, SIGNAL(DeleteFilesRequest(QStringList)));
-    connect(m_StylesInCSSFilesWidget, SIGNAL(DeleteStylesRequest(QList<BookReports::StyleData *>)), this, SIGNAL(DeleteStylesRequest(QList<BookReports::StyleData *>)));
+    connect(m_CSSFilesWidget, SIGNAL(DeleteFilesRequest(QStringList)), this, SLOT(DeleteFiles(QStringList)));
+    connect(m_StylesInCSSFilesWidget, SIGNAL(DeleteStylesRequest(QList<BookReports::StyleData *>)), this, SLOT(DeleteStyles(QList<BookReports::StyleData *>)));
     connect(m_CharactersInHTMLFilesWidget, SIGNAL(FindText(QString)), this, SIGNAL(FindText(QString)));
 
     connect(ui.availableWidgets, SIGNAL(currentItemChanged(QListWidgetItem *, QListWidgetItem *)), this, SLOT(selectPWidget(QListWidgetItem *, QListWidgetItem *)));
     connect(this, SIGNAL(finished(int)), this, SLOT(saveSettings()));
-    connect(ui.Refresh, SIGNAL(clicked()), this, SIGNAL(Refresh()));
+    connect(ui.Refresh, SIGNAL(clicked()), this, SLOT(RefreshReports()));
 }
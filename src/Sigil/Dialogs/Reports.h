@@ -48,6 +48,13 @@ public:
 
     void CreateReports(QSharedPointer< Book > book);
 
+    /**
+     * Waits until every report has gathered its data.
+     * Must be called before the book's resources are
+     * deleted or the book is closed.
+     */
+    void WaitForReports();
+
 signals:
     void Refresh();
     void OpenFileRequest(QString, int);
@@ -68,6 +75,14 @@ private slots:
      */
     void saveSettings();
 
+    /**
+     * Forward the requests of the reports once none
+     * of them is still gathering its data.
+     */
+    void DeleteFiles(QStringList files_to_delete);
+    void DeleteStyles(QList<BookReports::StyleData *> styles_to_delete);
+    void RefreshReports();
+
 private:
     void readSettings();
 
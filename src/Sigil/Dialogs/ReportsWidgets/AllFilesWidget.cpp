@@ -50,10 +50,13 @@ AllFilesWidget::AllFilesWidget()
     connectSignalsSlots();
 }
 
-void AllFilesWidget::CreateReport(QSharedPointer< Book > book)
+void AllFilesWidget::LoadReportData(const QList<BookReports::ResourceSnapshot> &resources)
+{
+    m_AllResources = resources;
+}
+
+void AllFilesWidget::FillReport()
 {
-    m_Book = book;
-    m_AllResources = m_Book->GetAllResources();
     SetupTable();
 }
 
@@ -71,12 +74,11 @@ void AllFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
     ui.fileTree->setModel(m_ItemModel);
     ui.fileTree->header()->setSortIndicatorShown(true);
     double total_size = 0;
-    QString main_folder = m_Book->GetFolderKeeper().GetFullPathToMainFolder();
-    foreach(Resource *resource, m_AllResources) {
-        QString fullpath = resource->GetFullPath();
-        QString filepath = resource->GetRelativePath();
-        QString directory = resource->GetFolder();
-        QString filename = resource->Filename();
+    foreach(const BookReports::ResourceSnapshot &resource, m_AllResources) {
+        QString fullpath = resource.full_path;
+        QString filepath = resource.relative_path;
+        QString directory = resource.folder;
+        QString filename = resource.filename;
         QList<QStandardItem *> rowItems;
         QStandardItem *item;
         // Directory
@@ -97,11 +99,11 @@ void AllFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         rowItems << size_item;
         // Type
         item = new QStandardItem();
-        item ->setText(GetType(resource));
+        item ->setText(GetType(resource.type));
         rowItems << item;
         // Semantics
         item = new QStandardItem();
-        item->setText(m_Book->GetOPF().GetGuideSemanticNameForResource(resource));
+        item->setText(resource.semantic_name);
         rowItems << item;
 
         // Add item to table
@@ -257,11 +259,11 @@ void AllFilesWidget::Save()
     WriteSettings();
 }
 
-QString AllFilesWidget::GetType(Resource *resource)
+QString AllFilesWidget::GetType(Resource::ResourceType resource_type)
 {
     QString type;
 
-    switch (resource->Type()) {
+    switch (resource_type) {
         case Resource::HTMLResourceType: {
             type = "HTML";
             break;
@@ -48,10 +48,12 @@ class AllFilesWidget : public ReportsWidget
 public:
     AllFilesWidget();
 
-    void CreateReport(QSharedPointer< Book > book);
-
     void SetupTable(int sort_column = 1, Qt::SortOrder sort_order = Qt::AscendingOrder);
 
+protected:
+    void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources);
+    void FillReport();
+
 signals:
     void CloseDialog();
     void DeleteFilesRequest(QStringList);
@@ -67,15 +69,13 @@ private slots:
     void Save();
 
 private:
-    QString GetType(Resource *resource);
+    QString GetType(Resource::ResourceType resource_type);
     void ReadSettings();
     void WriteSettings();
 
     void connectSignalsSlots();
 
-    QList<Resource *> m_AllResources;
-
-    QSharedPointer< Book > m_Book;
+    QList<BookReports::ResourceSnapshot> m_AllResources;
 
     QStandardItemModel *m_ItemModel;
 
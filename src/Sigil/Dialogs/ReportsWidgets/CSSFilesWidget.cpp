@@ -29,6 +29,7 @@
 
 #include "sigil_exception.h"
 #include "BookManipulation/FolderKeeper.h"
+#include "BookManipulation/XhtmlDoc.h"
 #include "Dialogs/ReportsWidgets/CSSFilesWidget.h"
 #include "Misc/NumericItem.h"
 #include "Misc/SettingsStore.h"
@@ -53,11 +54,26 @@ CSSFilesWidget::CSSFilesWidget()
     connectSignalsSlots();
 }
 
-void CSSFilesWidget::CreateReport(QSharedPointer< Book > book)
+void CSSFilesWidget::LoadReportData(const QList<BookReports::ResourceSnapshot> &resources)
+{
+    m_CSSResources.clear();
+    // Get all a count of all the linked stylesheets
+    m_LinkedStylesheets.clear();
+    foreach(const BookReports::ResourceSnapshot &resource, resources) {
+        if (resource.type == Resource::CSSResourceType) {
+            m_CSSResources.append(resource);
+        } else if (resource.type == Resource::HTMLResourceType) {
+            // Get the linked stylesheets for this file
+            QStringList linked_stylesheets = XhtmlDoc::GetLinkedStylesheets(resource.text);
+            foreach(QString stylesheet, linked_stylesheets) {
+                m_LinkedStylesheets[stylesheet]++;
+            }
+        }
+    }
+}
+
+void CSSFilesWidget::FillReport()
 {
-    m_Book = book;
-    m_HTMLResources = m_Book->GetFolderKeeper().GetResourceTypeList< HTMLResource >(false);
-    m_CSSResources = m_Book->GetFolderKeeper().GetResourceTypeList< CSSResource >(false);
     SetupTable();
 }
 
@@ -72,29 +88,15 @@ void CSSFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
     ui.fileTree->setSelectionBehavior(QAbstractItemView::SelectRows);
     ui.fileTree->setModel(m_ItemModel);
     ui.fileTree->header()->setSortIndicatorShown(true);
-    // Get all a count of all the linked stylesheets
-    QHash<QString, int> linked_stylesheets_hash;
-    foreach(HTMLResource * html_resource, m_HTMLResources) {
-        QString html_filename = html_resource->Filename();
-        // Get the linked stylesheets for this file
-        QStringList linked_stylesheets = m_Book->GetStylesheetsInHTMLFile(html_resource);
-        foreach(QString stylesheet, linked_stylesheets) {
-            if (linked_stylesheets.contains(stylesheet)) {
-                linked_stylesheets_hash[stylesheet]++;
-            } else {
-                linked_stylesheets_hash[stylesheet] = 1;
-            }
-        }
-    }
     double total_size = 0;
     int total_links = 0;
-    foreach(CSSResource * css_resource, m_CSSResources) {
-        QString filepath = "../" + css_resource->GetRelativePathToOEBPS();
-        QString path = css_resource->GetFullPath();
+    foreach(const BookReports::ResourceSnapshot &css_resource, m_CSSResources) {
+        QString filepath = "../" + css_resource.relative_path_to_oebps;
+        QString path = css_resource.full_path;
         QList<QStandardItem *> rowItems;
         // Filename
         QStandardItem *name_item = new QStandardItem();
-        name_item->setText(css_resource->Filename());
+        name_item->setText(css_resource.filename);
         name_item->setToolTip(filepath);
         rowItems << name_item;
         // File Size
@@ -105,11 +107,7 @@ void CSSFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         size_item->setText(fsize);
         rowItems << size_item;
         // Times Used
-        int count = 0;
-
-        if (linked_stylesheets_hash.contains(filepath)) {
-            count = linked_stylesheets_hash[filepath];
-        }
+        int count = m_LinkedStylesheets.value(filepath);
 
         total_links += count;
         NumericItem *link_item = new NumericItem();
@@ -47,10 +47,12 @@ class CSSFilesWidget : public ReportsWidget
 public:
     CSSFilesWidget();
 
-    void CreateReport(QSharedPointer< Book > book);
-
     void SetupTable(int sort_column = 1, Qt::SortOrder sort_order = Qt::AscendingOrder);
 
+protected:
+    void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources);
+    void FillReport();
+
 signals:
     void CloseDialog();
     void DeleteFilesRequest(QStringList);
@@ -76,10 +78,12 @@ private:
 
     void connectSignalsSlots();
 
-    QList<HTMLResource *> m_HTMLResources;
-    QList<CSSResource *> m_CSSResources;
+    QList<BookReports::ResourceSnapshot> m_CSSResources;
 
-    QSharedPointer<Book> m_Book;
+    /**
+     * The number of HTML files linking each stylesheet.
+     */
+    QHash<QString, int> m_LinkedStylesheets;
 
     QStandardItemModel *m_ItemModel;
 
@@ -54,9 +54,15 @@ CharactersInHTMLFilesWidget::CharactersInHTMLFilesWidget()
     connectSignalsSlots();
 }
 
-void CharactersInHTMLFilesWidget::CreateReport(QSharedPointer< Book > book)
+void CharactersInHTMLFilesWidget::LoadReportData(const QList<BookReports::ResourceSnapshot> &resources)
+{
+    // The characters are read back from WebKit, which only runs on
+    // the GUI thread, so this report is gathered when it is shown.
+    Q_UNUSED(resources)
+}
+
+void CharactersInHTMLFilesWidget::FillReport()
 {
-    m_Book = book;
     SetupTable();
     AddTableData();
 
@@ -45,7 +45,9 @@ class CharactersInHTMLFilesWidget : public ReportsWidget
 public:
     CharactersInHTMLFilesWidget();
 
-    void CreateReport(QSharedPointer< Book > m_Book);
+protected:
+    void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources);
+    void FillReport();
 
 signals:
     void CloseDialog();
@@ -71,8 +73,6 @@ private:
 
     QList < QChar > GetDisplayedCharacters(QList< HTMLResource * > resources);
 
-    QSharedPointer< Book > m_Book;
-
     QStandardItemModel *m_ItemModel;
 
     QString m_LastDirSaved;
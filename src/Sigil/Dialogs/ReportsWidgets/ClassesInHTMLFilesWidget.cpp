@@ -51,12 +51,15 @@ ClassesInHTMLFilesWidget::ClassesInHTMLFilesWidget()
     connectSignalsSlots();
 }
 
-void ClassesInHTMLFilesWidget::CreateReport(QSharedPointer< Book > book)
+void ClassesInHTMLFilesWidget::LoadReportData(const QList<BookReports::ResourceSnapshot> &resources)
+{
+    m_HTMLClassesUsage = BookReports::GetHTMLClassUsage(resources);
+}
+
+void ClassesInHTMLFilesWidget::FillReport()
 {
-    m_Book = book;
     SetupTable();
-    QList<BookReports::StyleData *> html_classes_usage = BookReports::GetHTMLClassUsage(m_Book);
-    AddTableData(html_classes_usage);
+    AddTableData(m_HTMLClassesUsage);
 
     for (int i = 0; i < ui.fileTree->header()->count(); i++) {
         ui.fileTree->resizeColumnToContents(i);
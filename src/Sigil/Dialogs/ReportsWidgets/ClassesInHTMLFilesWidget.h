@@ -45,7 +45,9 @@ class ClassesInHTMLFilesWidget : public ReportsWidget
 public:
     ClassesInHTMLFilesWidget();
 
-    void CreateReport(QSharedPointer< Book > book);
+protected:
+    void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources);
+    void FillReport();
 
 signals:
     void CloseDialog();
@@ -66,7 +68,7 @@ private:
     void SetupTable();
     void AddTableData(QList<BookReports::StyleData *> html_classes_usage);
 
-    QSharedPointer< Book > m_Book;
+    QList<BookReports::StyleData *> m_HTMLClassesUsage;
 
     QStandardItemModel *m_ItemModel;
 
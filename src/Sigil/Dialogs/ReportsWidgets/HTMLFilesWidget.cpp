@@ -29,12 +29,17 @@
 
 #include "sigil_exception.h"
 #include "BookManipulation/FolderKeeper.h"
+#include "BookManipulation/XercesCppUse.h"
+#include "BookManipulation/XhtmlDoc.h"
 #include "Dialogs/ReportsWidgets/HTMLFilesWidget.h"
 #include "Misc/HTMLSpellCheck.h"
 #include "Misc/NumericItem.h"
 #include "Misc/SettingsStore.h"
 #include "Misc/Utility.h"
 #include "ResourceObjects/HTMLResource.h"
+#include "sigil_constants.h"
+
+using boost::shared_ptr;
 
 static const QString SETTINGS_GROUP = "reports";
 static const QString DEFAULT_REPORT_FILE = "HTMLFilesReport.csv";
@@ -53,10 +58,37 @@ HTMLFilesWidget::HTMLFilesWidget()
     connectSignalsSlots();
 }
 
-void HTMLFilesWidget::CreateReport(QSharedPointer< Book > book)
+void HTMLFilesWidget::LoadReportData(const QList<BookReports::ResourceSnapshot> &resources)
+{
+    m_HTMLResources.clear();
+    m_StylesheetNames.clear();
+    m_ImageNames.clear();
+    m_VideoNames.clear();
+    m_AudioNames.clear();
+    m_AllWords.clear();
+    m_MisspelledWords.clear();
+    m_WellFormed.clear();
+    foreach(const BookReports::ResourceSnapshot &resource, resources) {
+        if (resource.type != Resource::HTMLResourceType) {
+            continue;
+        }
+
+        m_HTMLResources.append(resource);
+        const QString &filename = resource.filename;
+        const QString &text = resource.text;
+        m_StylesheetNames[filename] = XhtmlDoc::GetLinkedStylesheets(text);
+        shared_ptr< xc::DOMDocument > document = XhtmlDoc::LoadTextIntoDocument(text);
+        m_ImageNames[filename] = XhtmlDoc::GetAllMediaPathsFromMediaChildren(*document, IMAGE_TAGS);
+        m_VideoNames[filename] = XhtmlDoc::GetAllMediaPathsFromMediaChildren(*document, VIDEO_TAGS);
+        m_AudioNames[filename] = XhtmlDoc::GetAllMediaPathsFromMediaChildren(*document, AUDIO_TAGS);
+        m_AllWords[filename] = HTMLSpellCheck::CountAllWords(text);
+        m_MisspelledWords[filename] = HTMLSpellCheck::CountMisspelledWords(text);
+        m_WellFormed[filename] = XhtmlDoc::WellFormedErrorForSource(text).line == -1;
+    }
+}
+
+void HTMLFilesWidget::FillReport()
 {
-    m_Book = book;
-    m_HTMLResources = m_Book->GetFolderKeeper().GetResourceTypeList< HTMLResource >(false);
     SetupTable();
 }
 
@@ -86,14 +118,10 @@ void HTMLFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
     int total_audio = 0;
     int total_stylesheets = 0;
     int total_wellformed = 0;
-    QHash<QString, QStringList> stylesheet_names_hash = m_Book->GetStylesheetsInHTMLFiles();
-    QHash<QString, QStringList> image_names_hash = m_Book->GetImagesInHTMLFiles();
-    QHash<QString, QStringList> video_names_hash = m_Book->GetVideoInHTMLFiles();
-    QHash<QString, QStringList> audio_names_hash = m_Book->GetAudioInHTMLFiles();
-    foreach(HTMLResource *html_resource, m_HTMLResources) {
-        QString filepath = "../" + html_resource->GetRelativePathToOEBPS();
-        QString path = html_resource->GetFullPath();
-        QString filename = html_resource->Filename();
+    foreach(const BookReports::ResourceSnapshot &html_resource, m_HTMLResources) {
+        QString filepath = "../" + html_resource.relative_path_to_oebps;
+        QString path = html_resource.full_path;
+        QString filename = html_resource.filename;
         QList<QStandardItem *> rowItems;
         // Filename
         QStandardItem *name_item = new QStandardItem();
@@ -108,20 +136,20 @@ void HTMLFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         size_item->setText(fsize);
         rowItems << size_item;
         // All words
-        int all_words = HTMLSpellCheck::CountAllWords(html_resource->GetText());
+        int all_words = m_AllWords.value(filename);
         total_all_words += all_words;
         NumericItem *words_item = new NumericItem();
         words_item->setText(QString::number(all_words));
         rowItems << words_item;
         // Misspelled words
-        int misspelled_words = HTMLSpellCheck::CountMisspelledWords(html_resource->GetText());
+        int misspelled_words = m_MisspelledWords.value(filename);
         total_misspelled_words += misspelled_words;
         NumericItem *misspelled_item = new NumericItem();
         misspelled_item->setText(QString::number(misspelled_words));
         rowItems << misspelled_item;
         // Images
         NumericItem *image_item = new NumericItem();
-        QStringList image_names = image_names_hash[filename];
+        QStringList image_names = m_ImageNames.value(filename);
         total_images += image_names.count();
         image_item->setText(QString::number(image_names.count()));
         if (!image_names.isEmpty()) {
@@ -130,7 +158,7 @@ void HTMLFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         rowItems << image_item;
         // Video
         NumericItem *video_item = new NumericItem();
-        QStringList video_names = video_names_hash[filename];
+        QStringList video_names = m_VideoNames.value(filename);
         total_video += video_names.count();
         video_item->setText(QString::number(video_names.count()));
         if (!video_names.isEmpty()) {
@@ -139,7 +167,7 @@ void HTMLFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         rowItems << video_item;
         // Audio
         NumericItem *audio_item = new NumericItem();
-        QStringList audio_names = audio_names_hash[filename];
+        QStringList audio_names = m_AudioNames.value(filename);
         total_audio += audio_names.count();
         audio_item->setText(QString::number(audio_names.count()));
         if (!audio_names.isEmpty()) {
@@ -148,7 +176,7 @@ void HTMLFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         rowItems << audio_item;
         // Linked Stylesheets
         NumericItem *stylesheet_item = new NumericItem();
-        QStringList stylesheet_names = stylesheet_names_hash[filename];
+        QStringList stylesheet_names = m_StylesheetNames.value(filename);
         total_stylesheets += stylesheet_names.count();
         stylesheet_item->setText(QString::number(stylesheet_names.count()));
         if (!stylesheet_names.isEmpty()) {
@@ -157,7 +185,7 @@ void HTMLFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         rowItems << stylesheet_item;
         // Well formed
         QStandardItem *wellformed_item = new QStandardItem();
-        wellformed = html_resource->FileIsWellFormed();
+        wellformed = m_WellFormed.value(filename);
         if (wellformed) {
             total_wellformed++;
         }
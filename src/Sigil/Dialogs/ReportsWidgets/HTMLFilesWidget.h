@@ -48,10 +48,12 @@ class HTMLFilesWidget : public ReportsWidget
 public:
     HTMLFilesWidget();
 
-    void CreateReport(QSharedPointer< Book > book);
-
     void SetupTable(int sort_column = 1, Qt::SortOrder sort_order = Qt::AscendingOrder);
 
+protected:
+    void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources);
+    void FillReport();
+
 signals:
     void CloseDialog();
     void DeleteFilesRequest(QStringList);
@@ -77,9 +79,19 @@ private:
 
     void connectSignalsSlots();
 
-    QList<HTMLResource *> m_HTMLResources;
+    QList<BookReports::ResourceSnapshot> m_HTMLResources;
+
+    /**
+     * The files each HTML file links to, by HTML filename.
+     */
+    QHash<QString, QStringList> m_StylesheetNames;
+    QHash<QString, QStringList> m_ImageNames;
+    QHash<QString, QStringList> m_VideoNames;
+    QHash<QString, QStringList> m_AudioNames;
 
-    QSharedPointer< Book > m_Book;
+    QHash<QString, int> m_AllWords;
+    QHash<QString, int> m_MisspelledWords;
+    QHash<QString, bool> m_WellFormed;
 
     QStandardItemModel *m_ItemModel;
 
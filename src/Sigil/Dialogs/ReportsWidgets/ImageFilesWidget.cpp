@@ -28,12 +28,14 @@
 
 #include "sigil_exception.h"
 #include "BookManipulation/FolderKeeper.h"
+#include "BookManipulation/XhtmlDoc.h"
 #include "Dialogs/ReportsWidgets/ImageFilesWidget.h"
 #include "Misc/NumericItem.h"
 #include "Misc/SettingsStore.h"
 #include "Misc/Utility.h"
 #include "ResourceObjects/ImageResource.h"
 #include "ResourceObjects/SVGResource.h"
+#include "sigil_constants.h"
 
 static const int THUMBNAIL_SIZE = 100;
 static const int THUMBNAIL_SIZE_INCREMENT = 50;
@@ -56,19 +58,40 @@ ImageFilesWidget::ImageFilesWidget()
     ReadSettings();
 }
 
-void ImageFilesWidget::CreateReport(QSharedPointer< Book > book)
+void ImageFilesWidget::LoadReportData(const QList<BookReports::ResourceSnapshot> &resources)
 {
-    m_Book = book;
     m_AllImageResources.clear();
-    QList<ImageResource *> image_resources = m_Book->GetFolderKeeper().GetResourceTypeList< ImageResource >(false);
-    QList<SVGResource *> svg_resources = m_Book->GetFolderKeeper().GetResourceTypeList< SVGResource >(false);
+    m_HTMLFilesUsingImages.clear();
     // Images actually consist of 2 resource types ImageResource and SVGResource
-    foreach(ImageResource * image_resource, image_resources) {
-        m_AllImageResources.append(image_resource);
+    foreach(const BookReports::ResourceSnapshot &resource, resources) {
+        if (resource.type == Resource::ImageResourceType) {
+            m_AllImageResources.append(resource);
+        }
+    }
+    foreach(const BookReports::ResourceSnapshot &resource, resources) {
+        if (resource.type == Resource::SVGResourceType) {
+            m_AllImageResources.append(resource);
+        } else if (resource.type == Resource::HTMLResourceType) {
+            QStringList image_paths = XhtmlDoc::GetAllMediaPathsFromMediaChildren(*XhtmlDoc::LoadTextIntoDocument(resource.text).get(), IMAGE_TAGS);
+            foreach(QString image_path, image_paths) {
+                m_HTMLFilesUsingImages[image_path].append(resource.filename);
+            }
+        }
     }
-    foreach(SVGResource * svg_resource, svg_resources) {
-        m_AllImageResources.append(svg_resource);
+    // Decoding every image is slow, so only what the table shows is kept.
+    m_ImageDetails.clear();
+    foreach(const BookReports::ResourceSnapshot &resource, m_AllImageResources) {
+        QImage image(resource.full_path);
+        ImageDetails details;
+        details.width = image.width();
+        details.height = image.height();
+        details.grayscale = image.allGray();
+        m_ImageDetails[resource.identifier] = details;
     }
+}
+
+void ImageFilesWidget::FillReport()
+{
     SetupTable();
 }
 
@@ -96,15 +119,14 @@ void ImageFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
     ui.fileTree->setIconSize(icon_size);
     double total_size = 0;
     int total_links = 0;
-    QHash<QString, QStringList> image_html_files_hash = m_Book->GetHTMLFilesUsingImages();
-    foreach(Resource * resource, m_AllImageResources) {
-        QString filepath = "../" + resource->GetRelativePathToOEBPS();
-        QString path = resource->GetFullPath();
-        QImage image(path);
+    foreach(const BookReports::ResourceSnapshot &resource, m_AllImageResources) {
+        QString filepath = "../" + resource.relative_path_to_oebps;
+        QString path = resource.full_path;
+        const ImageDetails &image = m_ImageDetails[resource.identifier];
         QList<QStandardItem *> rowItems;
         // Filename
         QStandardItem *name_item = new QStandardItem();
-        name_item->setText(resource->Filename());
+        name_item->setText(resource.filename);
         name_item->setToolTip(filepath);
         name_item->setData(filepath);
         rowItems << name_item;
@@ -116,7 +138,7 @@ void ImageFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         size_item->setText(fsize);
         rowItems << size_item;
         // Times Used
-        QStringList image_html_files = image_html_files_hash[filepath];
+        QStringList image_html_files = m_HTMLFilesUsingImages.value(filepath);
         total_links += image_html_files.count();
         NumericItem *link_item = new NumericItem();
         link_item->setText(QString::number(image_html_files.count()));
@@ -128,24 +150,24 @@ void ImageFilesWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         rowItems << link_item;
         // Width
         NumericItem *width_item = new NumericItem();
-        width_item->setText(QString::number(image.width()));
+        width_item->setText(QString::number(image.width));
         rowItems << width_item;
         // Height
         NumericItem *height_item = new NumericItem();
-        height_item->setText(QString::number(image.height()));
+        height_item->setText(QString::number(image.height));
         rowItems << height_item;
         // Pixels
         NumericItem *pixel_item = new NumericItem();
-        pixel_item->setText(QString::number(image.width() * image.height()));
+        pixel_item->setText(QString::number(image.width * image.height));
         rowItems << pixel_item;
         // Color
         QStandardItem *color_item = new QStandardItem();
-        color_item->setText(image.allGray() ? "Grayscale" : "Color");
+        color_item->setText(image.grayscale ? "Grayscale" : "Color");
         rowItems << color_item;
 
         // Thumbnail
         if (m_ThumbnailSize) {
-            QPixmap pixmap(resource->GetFullPath());
+            QPixmap pixmap(path);
 
             if (pixmap.height() > m_ThumbnailSize || pixmap.width() > m_ThumbnailSize) {
                 pixmap = pixmap.scaled(QSize(m_ThumbnailSize, m_ThumbnailSize), Qt::KeepAspectRatio);
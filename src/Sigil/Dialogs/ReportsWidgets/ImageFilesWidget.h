@@ -47,10 +47,12 @@ class ImageFilesWidget : public ReportsWidget
 public:
     ImageFilesWidget();
 
-    void CreateReport(QSharedPointer< Book > book);
-
     void SetupTable(int sort_column = 1, Qt::SortOrder sort_order = Qt::AscendingOrder);
 
+protected:
+    void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources);
+    void FillReport();
+
 signals:
     void CloseDialog();
     void DeleteFilesRequest(QStringList);
@@ -73,6 +75,15 @@ private slots:
     void Save();
 
 private:
+    /**
+     * What the table shows of a decoded image.
+     */
+    struct ImageDetails {
+        int width;
+        int height;
+        bool grayscale;
+    };
+
     void ReadSettings();
     void WriteSettings();
 
@@ -81,9 +92,14 @@ private:
 
     void connectSignalsSlots();
 
-    QList<Resource *> m_AllImageResources;
+    QList<BookReports::ResourceSnapshot> m_AllImageResources;
+
+    QHash<QString, QStringList> m_HTMLFilesUsingImages;
 
-    QSharedPointer<Book> m_Book;
+    /**
+     * The decoded image details, by resource identifier.
+     */
+    QHash<QString, ImageDetails> m_ImageDetails;
 
     QStandardItemModel *m_ItemModel;
 
@@ -50,11 +50,24 @@ LinksWidget::LinksWidget()
     connectSignalsSlots();
 }
 
-void LinksWidget::CreateReport(QSharedPointer< Book > book)
+void LinksWidget::LoadReportData(const QList<BookReports::ResourceSnapshot> &resources)
 {
-    m_Book = book;
-    m_HTMLResources = m_Book->GetFolderKeeper().GetResourceTypeList< HTMLResource >(false);
+    m_HTMLResources.clear();
+    m_Links.clear();
+    m_Ids.clear();
+    foreach(const BookReports::ResourceSnapshot &resource, resources) {
+        if (resource.type != Resource::HTMLResourceType) {
+            continue;
+        }
 
+        m_HTMLResources.append(resource);
+        m_Links[resource.filename] = XhtmlDoc::GetTagsInDocument(resource.text, "a");
+        m_Ids[resource.filename] = XhtmlDoc::GetAllDescendantIDs(*XhtmlDoc::LoadTextIntoDocument(resource.text).get()->getDocumentElement());
+    }
+}
+
+void LinksWidget::FillReport()
+{
     SetupTable();
 }
 
@@ -80,19 +93,19 @@ void LinksWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
         tr("Report shows all source and target links using the anchor tag \"a\".")
         );
 
-    QHash< QString, QList< XhtmlDoc::XMLElement > > links = m_Book->GetLinkElements();
-    QHash<QString, QStringList> all_ids = m_Book->GetIdsInHTMLFiles();
+    const QHash< QString, QList< XhtmlDoc::XMLElement > > &links = m_Links;
+    const QHash<QString, QStringList> &all_ids = m_Ids;
     QStringList html_filenames;
-    foreach(Resource *resource, m_HTMLResources) {
-        html_filenames.append(resource->Filename());
+    foreach(const BookReports::ResourceSnapshot &resource, m_HTMLResources) {
+        html_filenames.append(resource.filename);
     }
 
-    foreach(Resource *resource, m_HTMLResources) {
-        QString filepath = "../" + resource->GetRelativePathToOEBPS();
-        QString path = resource->GetFullPath();
-        QString filename = resource->Filename();
+    foreach(const BookReports::ResourceSnapshot &resource, m_HTMLResources) {
+        QString filepath = "../" + resource.relative_path_to_oebps;
+        QString path = resource.full_path;
+        QString filename = resource.filename;
 
-        foreach(XhtmlDoc::XMLElement element, links[filename]) {
+        foreach(XhtmlDoc::XMLElement element, links.value(filename)) {
             QList<QStandardItem *> rowItems;
 
             // Source file
@@ -149,7 +162,7 @@ void LinksWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
                         file = filename;
                     }
                     if (html_filenames.contains(file)) {
-                        if (href_id.isEmpty() || all_ids[file].contains(href_id)) {
+                        if (href_id.isEmpty() || all_ids.value(file).contains(href_id)) {
                             target_valid = "yes";
                         }
                     }
@@ -169,7 +182,7 @@ void LinksWidget::SetupTable(int sort_column, Qt::SortOrder sort_order)
                 if (target_file.isEmpty()) {
                     target_file = filename;
                 }
-                foreach(XhtmlDoc::XMLElement target_element, links[target_file]) {
+                foreach(XhtmlDoc::XMLElement target_element, links.value(target_file)) {
                     if (href_id == target_element.attributes["id"]) {
                         target = target_element;
                         found = true;
@@ -48,10 +48,12 @@ class LinksWidget : public ReportsWidget
 public:
     LinksWidget();
 
-    void CreateReport(QSharedPointer< Book > book);
-
     void SetupTable(int sort_column = 1, Qt::SortOrder sort_order = Qt::AscendingOrder);
 
+protected:
+    void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources);
+    void FillReport();
+
 signals:
     void CloseDialog();
     void DeleteFilesRequest(QStringList);
@@ -71,9 +73,10 @@ private:
 
     void connectSignalsSlots();
 
-    QList<HTMLResource *> m_HTMLResources;
+    QList<BookReports::ResourceSnapshot> m_HTMLResources;
 
-    QSharedPointer< Book > m_Book;
+    QHash< QString, QList< XhtmlDoc::XMLElement > > m_Links;
+    QHash<QString, QStringList> m_Ids;
 
     QStandardItemModel *m_ItemModel;
 
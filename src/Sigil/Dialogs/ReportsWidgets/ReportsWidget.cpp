@@ -0,0 +1,86 @@
+/************************************************************************
+**
+**  Copyright (C) 2026  agent <agent@local>
+**
+**  This file is part of Sigil.
+**
+**  Sigil is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  Sigil is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with Sigil.  If not, see <http://www.gnu.org/licenses/>.
+**
+*************************************************************************/
+
+#include <QtConcurrent/QtConcurrent>
+#include <QtWidgets/QApplication>
+
+#include "Dialogs/ReportsWidgets/ReportsWidget.h"
+
+ReportsWidget::ReportsWidget()
+    :
+    m_ReportCreated(false),
+    m_ReportFilled(false)
+{
+    connect(&m_ReportWatcher, SIGNAL(finished()), this, SLOT(ReportDataLoaded()));
+}
+
+ReportsWidget::~ReportsWidget()
+{
+    m_ReportWatcher.waitForFinished();
+}
+
+void ReportsWidget::CreateReport(QSharedPointer< Book > book, const QList<BookReports::ResourceSnapshot> &resources)
+{
+    // The data of the previous report may still be in use.
+    m_ReportWatcher.waitForFinished();
+    m_Book = book;
+    m_ReportCreated = true;
+    m_ReportFilled = false;
+    // The widget reads the data while it is being gathered.
+    setEnabled(false);
+    m_ReportWatcher.setFuture(QtConcurrent::run(this, &ReportsWidget::LoadReportData, resources));
+}
+
+void ReportsWidget::WaitForReport()
+{
+    if (!m_ReportCreated || m_ReportFilled) {
+        return;
+    }
+
+    if (!m_ReportWatcher.isFinished()) {
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        m_ReportWatcher.waitForFinished();
+        QApplication::restoreOverrideCursor();
+    }
+
+    m_ReportFilled = true;
+    FillReport();
+    setEnabled(true);
+}
+
+void ReportsWidget::WaitForReportData()
+{
+    m_ReportWatcher.waitForFinished();
+}
+
+void ReportsWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    WaitForReport();
+}
+
+void ReportsWidget::ReportDataLoaded()
+{
+    // Hidden reports are filled in when they are shown.
+    if (isVisible()) {
+        WaitForReport();
+    }
+}
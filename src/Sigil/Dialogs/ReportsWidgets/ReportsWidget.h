@@ -23,20 +23,75 @@
 #ifndef REPORTSWIDGET_H
 #define REPORTSWIDGET_H
 
+#include <QtCore/QFutureWatcher>
 #include <QWidget>
 
 #include "ResourceObjects/Resource.h"
 #include "BookManipulation/Book.h"
+#include "BookManipulation/BookReports.h"
 
 /**
  * Base Interface for reports widgets.
+ *
+ * The data of a report is gathered on a worker thread from copies
+ * of the resources taken on the GUI thread. The widget itself is
+ * only filled in once that data is ready and the report is shown,
+ * so hidden reports never block the GUI.
  */
 class ReportsWidget : public QWidget
 {
     Q_OBJECT
 
 public:
-    virtual void CreateReport(QSharedPointer< Book > book) = 0;
+    ReportsWidget();
+    ~ReportsWidget();
+
+    /**
+     * Starts gathering the report data for the book.
+     *
+     * @param book The book the report is for.
+     * @param resources The book's resources, as taken on the GUI thread.
+     */
+    void CreateReport(QSharedPointer< Book > book, const QList<BookReports::ResourceSnapshot> &resources);
+
+    /**
+     * Waits for the report data if needed and fills in the widget.
+     * Does nothing if the widget already shows the latest report.
+     */
+    void WaitForReport();
+
+    /**
+     * Waits until the report data is gathered, without filling in the widget.
+     */
+    void WaitForReportData();
+
+protected:
+    /**
+     * Gathers the report data. Runs on a worker thread, so it
+     * must not touch any widget, resource or the book itself.
+     */
+    virtual void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources) = 0;
+
+    /**
+     * Fills in the widget from the data gathered by LoadReportData.
+     */
+    virtual void FillReport() = 0;
+
+    void showEvent(QShowEvent *event);
+
+    /**
+     * The book of the report. Only for use on the GUI thread.
+     */
+    QSharedPointer< Book > m_Book;
+
+private slots:
+    void ReportDataLoaded();
+
+private:
+    QFutureWatcher< void > m_ReportWatcher;
+
+    bool m_ReportCreated;
+    bool m_ReportFilled;
 };
 
 #endif // REPORTSWIDGET_H
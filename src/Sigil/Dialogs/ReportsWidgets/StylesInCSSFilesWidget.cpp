@@ -52,15 +52,18 @@ StylesInCSSFilesWidget::StylesInCSSFilesWidget()
     connectSignalsSlots();
 }
 
-void StylesInCSSFilesWidget::CreateReport(QSharedPointer< Book > book)
+void StylesInCSSFilesWidget::LoadReportData(const QList<BookReports::ResourceSnapshot> &resources)
 {
-    m_Book = book;
-    SetupTable();
     // Get the list of classes in HTML and what selectors they match
-    QList<BookReports::StyleData *> html_classes_usage = BookReports::GetHTMLClassUsage(m_Book);
+    QList<BookReports::StyleData *> html_classes_usage = BookReports::GetHTMLClassUsage(resources);
     // Get the list of selectors in CSS files and if they were matched by HTML classes
-    QList<BookReports::StyleData *> css_selector_usage = BookReports::GetCSSSelectorUsage(m_Book, html_classes_usage);
-    AddTableData(css_selector_usage);
+    m_CSSSelectorsUsage = BookReports::GetCSSSelectorUsage(resources, html_classes_usage);
+}
+
+void StylesInCSSFilesWidget::FillReport()
+{
+    SetupTable();
+    AddTableData(m_CSSSelectorsUsage);
 
     for (int i = 0; i < ui.fileTree->header()->count(); i++) {
         ui.fileTree->resizeColumnToContents(i);
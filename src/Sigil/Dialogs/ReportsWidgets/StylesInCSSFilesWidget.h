@@ -48,7 +48,9 @@ class StylesInCSSFilesWidget : public ReportsWidget
 public:
     StylesInCSSFilesWidget();
 
-    void CreateReport(QSharedPointer< Book > book);
+protected:
+    void LoadReportData(const QList<BookReports::ResourceSnapshot> &resources);
+    void FillReport();
 
 signals:
     void CloseDialog();
@@ -77,7 +79,7 @@ private:
 
     void AddTableData(QList<BookReports::StyleData *> css_selectors_usage);
 
-    QSharedPointer< Book > m_Book;
+    QList<BookReports::StyleData *> m_CSSSelectorsUsage;
 
     QStandardItemModel *m_ItemModel;
 
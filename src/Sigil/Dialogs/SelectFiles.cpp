@@ -20,12 +20,16 @@
 **
 *************************************************************************/
 
+#include <boost/bind/bind.hpp>
+
 #include <QtCore/QFileInfo>
+#include <QtConcurrent/QtConcurrent>
 #include <QtWidgets/QLayout>
 #include <QtWebKitWidgets/QWebFrame>
 #include <QtWebKitWidgets/QWebView>
 
 #include "Dialogs/SelectFiles.h"
+#include "Misc/RasterizeImageResource.h"
 #include "Misc/SettingsStore.h"
 #include "sigil_constants.h"
 
@@ -57,7 +61,8 @@ SelectFiles::SelectFiles(QString title, QList<Resource *> media_resources, QStri
     m_DefaultSelectedImage(default_selected_image),
     m_ThumbnailSize(THUMBNAIL_SIZE),
     m_IsInsertFromDisk(false),
-    m_WebView(new QWebView(this))
+    m_WebView(new QWebView(this)),
+    m_Rasterizer(new RasterizeImageResource(this))
 {
     ui.setupUi(this);
     setWindowTitle(title);
@@ -112,6 +117,8 @@ QStringList SelectFiles::SelectedImages()
 void SelectFiles::SetImages()
 {
     ui.Details->clear();
+    // The items are about to be deleted along with the model rows
+    m_PendingThumbnails.clear();
     m_WebView->setHtml("", QUrl());
 
     m_SelectFilesModel->clear();
@@ -130,6 +137,24 @@ void SelectFiles::SetImages()
     ui.imageTree->setSortingEnabled(true);
     int row = 0;
 
+    // Rasterize the thumbnails in parallel, they are cached across calls
+    QHash<QString, QImage> thumbnails;
+
+    if (m_ThumbnailSize && m_ImageItem->isSelected()) {
+        QStringList image_paths;
+        foreach(Resource *resource, m_MediaResources) {
+            if (resource->Type() == Resource::ImageResourceType || resource->Type() == Resource::SVGResourceType) {
+                image_paths.append(resource->GetFullPath());
+            }
+        }
+        QFuture<QImage> future = QtConcurrent::mapped(image_paths,
+                                 boost::bind(RasterizeImageResource::RasterizeFileToFit, _1, m_ThumbnailSize));
+
+        for (int i = 0; i < future.results().count(); i++) {
+            thumbnails[image_paths.at(i)] = future.resultAt(i);
+        }
+    }
+
     foreach(Resource *resource, m_MediaResources) {
         // Don't show resources not matching the selected type
         Resource::ResourceType type = resource->Type();
@@ -151,15 +176,18 @@ void SelectFiles::SetImages()
 
         // Do not show thumbnail if file is not an image
         if ((type == Resource::ImageResourceType || type == Resource::SVGResourceType) && m_ThumbnailSize) {
-            QPixmap pixmap(resource->GetFullPath());
+            QPixmap pixmap = QPixmap::fromImage(thumbnails.value(resource->GetFullPath()));
+            QStandardItem *icon_item = new QStandardItem();
+            icon_item->setEditable(false);
 
-            if (pixmap.height() > m_ThumbnailSize || pixmap.width() > m_ThumbnailSize) {
-                pixmap = pixmap.scaled(QSize(m_ThumbnailSize, m_ThumbnailSize), Qt::KeepAspectRatio);
+            // SVGs only webkit can render get their thumbnail once it is ready
+            if (pixmap.isNull() && type == Resource::SVGResourceType) {
+                m_PendingThumbnails[resource->GetFullPath()] = icon_item;
+                m_Rasterizer->Rasterize(*resource, 1.0);
+            } else {
+                icon_item->setIcon(QIcon(pixmap));
             }
 
-            QStandardItem *icon_item = new QStandardItem();
-            icon_item->setIcon(QIcon(pixmap));
-            icon_item->setEditable(false);
             rowItems << icon_item;
         }
 
@@ -179,6 +207,24 @@ void SelectFiles::SetImages()
     SelectDefaultImage();
 }
 
+void SelectFiles::ThumbnailRasterized(const QString &path, float zoom_factor, const QImage &image)
+{
+    Q_UNUSED(zoom_factor);
+    QStandardItem *icon_item = m_PendingThumbnails.take(path);
+
+    if (!icon_item || image.isNull()) {
+        return;
+    }
+
+    QPixmap pixmap = QPixmap::fromImage(image);
+
+    if (pixmap.height() > m_ThumbnailSize || pixmap.width() > m_ThumbnailSize) {
+        pixmap = pixmap.scaled(QSize(m_ThumbnailSize, m_ThumbnailSize), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    icon_item->setIcon(QIcon(pixmap));
+}
+
 void SelectFiles::SelectDefaultImage()
 {
     QStandardItem *root_item = m_SelectFilesModel->invisibleRootItem();
@@ -428,6 +474,8 @@ void SelectFiles::connectSignalsSlots()
     connect(ui.ThumbnailIncrease, SIGNAL(clicked()), this, SLOT(IncreaseThumbnailSize()));
     connect(ui.ThumbnailDecrease, SIGNAL(clicked()), this, SLOT(DecreaseThumbnailSize()));
     connect(ui.InsertFromDisk,  SIGNAL(clicked()), this, SLOT(InsertFromDisk()));
+    connect(m_Rasterizer,       SIGNAL(Rasterized(const QString &, float, const QImage &)),
+            this,               SLOT(ThumbnailRasterized(const QString &, float, const QImage &)));
     connect(ui.FileTypes,       SIGNAL(itemSelectionChanged()), this, SLOT(SetImages()));
 
     connect(ui.splitter,    SIGNAL(splitterMoved(int, int)), this, SLOT(SplitterMoved(int, int)));
@@ -25,6 +25,7 @@
 #ifndef SELECTFILES_H
 #define SELECTFILES_H
 
+#include <QtCore/QHash>
 #include <QtWidgets/QDialog>
 #include <QtGui/QStandardItemModel>
 
@@ -32,9 +33,11 @@
 
 #include "ui_SelectFiles.h"
 
+class QImage;
 class QString;
 class QStringList;
 class QWebView;
+class RasterizeImageResource;
 
 class SelectFiles : public QDialog
 {
@@ -85,6 +88,11 @@ private slots:
 
     void SplitterMoved(int pos, int index);
 
+    /**
+     * Shows a thumbnail that had to be rendered by webkit.
+     */
+    void ThumbnailRasterized(const QString &path, float zoom_factor, const QImage &image);
+
 private:
     void ReadSettings();
     void connectSignalsSlots();
@@ -113,6 +121,13 @@ private:
 
     QWebView *m_WebView;
 
+    RasterizeImageResource *m_Rasterizer;
+
+    /**
+     * The thumbnail items waiting on m_Rasterizer, by image path.
+     */
+    QHash<QString, QStandardItem *> m_PendingThumbnails;
+
     Ui::SelectFiles ui;
 };
 
@@ -20,8 +20,11 @@
 **
 *************************************************************************/
 
+#include <QtCore/QEventLoop>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QHashIterator>
 #include <QtCore/QSignalMapper>
+#include <QtConcurrent/QtConcurrent>
 #include <QtGui/QContextMenuEvent>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QPushButton>
@@ -49,7 +52,9 @@ SpellcheckEditor::SpellcheckEditor(QWidget *parent)
     m_SpellcheckEditorModel(new QStandardItemModel(this)),
     m_ContextMenu(new QMenu(this)),
     m_MultipleSelection(false),
-    m_SelectRow(-1)
+    m_SelectRow(-1),
+    m_ModelIsCurrent(false),
+    m_SpellingGeneration(-1)
 {
     ui.setupUi(this);
     ui.FilterText->installEventFilter(this);
@@ -69,6 +74,7 @@ SpellcheckEditor::~SpellcheckEditor()
 void SpellcheckEditor::SetBook(QSharedPointer <Book> book)
 {
     m_Book = book;
+    m_ModelIsCurrent = false;
 }
 
 void SpellcheckEditor::SetupSpellcheckEditorTree()
@@ -143,7 +149,9 @@ void SpellcheckEditor::Ignore()
 
     SpellCheck *sc = SpellCheck::instance();
     foreach (QStandardItem *item, GetSelectedItems()) {
+        int generation = sc->generation();
         sc->ignoreWord(item->text());
+        AcceptWord(item->text(), generation);
         MarkSpelledOkay(item->row());
     }
 
@@ -174,9 +182,11 @@ void SpellcheckEditor::Add()
     QStringList enabled_dicts = settings.enabledUserDictionaries();
     bool enabled = false;
     foreach (QStandardItem *item, GetSelectedItems()) {
+        int generation = sc->generation();
         sc->addToUserDictionary(item->text(), dict_name);
         if (enabled_dicts.contains(dict_name)) {
             enabled = true;
+            AcceptWord(item->text(), generation);
             MarkSpelledOkay(item->row());
         }
     }
@@ -230,6 +240,93 @@ void SpellcheckEditor::MarkSpelledOkay(int row)
     }
 }
 
+void SpellcheckEditor::AcceptWord(const QString &word, int generation_before)
+{
+    // If anything else changed the spellchecker in the meantime
+    // the cached results are stale anyway, so leave them to be dropped.
+    if (m_SpellingGeneration != generation_before) {
+        return;
+    }
+
+    m_Misspelled[word] = false;
+    m_SpellingGeneration = SpellCheck::instance()->generation();
+}
+
+void SpellcheckEditor::CheckSpelling(const QList<QString> &words)
+{
+    SpellCheck *sc = SpellCheck::instance();
+
+    if (m_SpellingGeneration != sc->generation()) {
+        m_Misspelled.clear();
+        m_SpellingGeneration = sc->generation();
+    }
+
+    QList<QString> unchecked_words;
+    foreach(QString word, words) {
+        if (!m_Misspelled.contains(word)) {
+            unchecked_words.append(word);
+        }
+    }
+
+    if (unchecked_words.isEmpty()) {
+        return;
+    }
+
+    // Keep the GUI painting while the words are checked.
+    QFutureWatcher< QHash<QString, bool> > watcher;
+    QEventLoop loop;
+    connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+    watcher.setFuture(QtConcurrent::run(SpellcheckWords, unchecked_words));
+
+    if (!watcher.isFinished()) {
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    }
+
+    m_Misspelled.unite(watcher.result());
+}
+
+QHash<QString, bool> SpellcheckEditor::SpellcheckWords(const QList<QString> &words)
+{
+    QHash<QString, bool> misspelled;
+    SpellCheck *sc = SpellCheck::instance();
+    foreach(QString word, words) {
+        misspelled[word] = !sc->spell(word);
+    }
+    return misspelled;
+}
+
+QList<QStandardItem *> SpellcheckEditor::CreateRowItems(const QString &word, int count, bool misspelled)
+{
+    QList<QStandardItem *> row_items;
+
+    if (ui.CaseInsensitiveSort->checkState() == Qt::Unchecked) {
+        QStandardItem *word_item = new QStandardItem(word);
+        word_item->setEditable(false);
+        row_items << word_item;
+    }
+    else {
+        CaseInsensitiveItem *word_item = new CaseInsensitiveItem();
+        word_item->setText(word);
+        word_item->setEditable(false);
+        row_items << word_item;
+    }
+    NumericItem *count_item = new NumericItem();
+    count_item->setText(QString::number(count));
+    row_items << count_item;
+
+    QStandardItem *misspelled_item = new QStandardItem();
+    misspelled_item->setEditable(false);
+    if (misspelled) {
+        misspelled_item->setText(tr("Yes"));
+    }
+    else {
+        misspelled_item->setText(tr("No"));
+    }
+    row_items << misspelled_item ;
+
+    return row_items;
+}
+
 void SpellcheckEditor::CreateModel(int sort_column, Qt::SortOrder sort_order)
 {
     m_SpellcheckEditorModel->clear();
@@ -243,60 +340,90 @@ void SpellcheckEditor::CreateModel(int sort_column, Qt::SortOrder sort_order)
     ui.SpellcheckEditorTree->resizeColumnToContents(2);
 
     QHash<QString, int> unique_words = m_Book->GetUniqueWordsInHTMLFiles();
-
-    int total_misspelled_words = 0;
-    SpellCheck *sc = SpellCheck::instance();
+    CheckSpelling(unique_words.keys());
 
     QHashIterator<QString, int> i(unique_words);
     while (i.hasNext()) {
         i.next();
-        QString word = i.key();
-        int count = unique_words.value(word);
-        
-        bool misspelled = !sc->spell(word);
-        if (misspelled) {
-            total_misspelled_words++;
-        }
+        bool misspelled = m_Misspelled.value(i.key());
 
         if (ui.ShowAllWords->checkState() == Qt::Unchecked && !misspelled) {
             continue;
         }
 
-        QList<QStandardItem *> row_items;
+        m_SpellcheckEditorModel->invisibleRootItem()->appendRow(CreateRowItems(i.key(), i.value(), misspelled));
+    }
+
+    SetSortIndicator(sort_column, sort_order);
+    UpdateTotals(unique_words);
+    m_ModelIsCurrent = true;
+}
+
+void SpellcheckEditor::UpdateModel(int sort_column, Qt::SortOrder sort_order)
+{
+    QHash<QString, int> unique_words = m_Book->GetUniqueWordsInHTMLFiles();
+    CheckSpelling(unique_words.keys());
+
+    bool show_all = ui.ShowAllWords->checkState() == Qt::Checked;
+    QStandardItem *root_item = m_SpellcheckEditorModel->invisibleRootItem();
+    QSet<QString> shown_words;
+
+    // Backwards, so removing a row does not move the rows still to be visited.
+    for (int row = root_item->rowCount() - 1; row >= 0; row--) {
+        const QString word = root_item->child(row, 0)->text();
+        bool misspelled = m_Misspelled.value(word);
 
-        if (ui.CaseInsensitiveSort->checkState() == Qt::Unchecked) {
-            QStandardItem *word_item = new QStandardItem(word);
-            word_item->setEditable(false);
-            row_items << word_item;
+        if (!unique_words.contains(word) || (!show_all && !misspelled)) {
+            root_item->removeRow(row);
+            continue;
         }
-        else {
-            CaseInsensitiveItem *word_item = new CaseInsensitiveItem();
-            word_item->setText(word);
-            word_item->setEditable(false);
-            row_items << word_item;
+
+        const QString count = QString::number(unique_words.value(word));
+        if (root_item->child(row, 1)->text() != count) {
+            root_item->child(row, 1)->setText(count);
         }
-        NumericItem *count_item = new NumericItem();
-        count_item->setText(QString::number(count));
-        row_items << count_item;
-
-        QStandardItem *misspelled_item = new QStandardItem();
-        misspelled_item->setEditable(false);
-        if (misspelled) {
-            misspelled_item->setText(tr("Yes"));
+
+        const QString misspelled_text = misspelled ? tr("Yes") : tr("No");
+        if (root_item->child(row, 2)->text() != misspelled_text) {
+            root_item->child(row, 2)->setText(misspelled_text);
         }
-        else {
-            misspelled_item->setText(tr("No"));
+
+        shown_words.insert(word);
+    }
+
+    QHashIterator<QString, int> i(unique_words);
+    while (i.hasNext()) {
+        i.next();
+        bool misspelled = m_Misspelled.value(i.key());
+
+        if (shown_words.contains(i.key()) || (!show_all && !misspelled)) {
+            continue;
         }
-        row_items << misspelled_item ;
 
-        m_SpellcheckEditorModel->invisibleRootItem()->appendRow(row_items);
+        root_item->appendRow(CreateRowItems(i.key(), i.value(), misspelled));
     }
 
+    m_SpellcheckEditorModel->sort(sort_column, sort_order);
+    SetSortIndicator(sort_column, sort_order);
+    UpdateTotals(unique_words);
+}
+
+void SpellcheckEditor::SetSortIndicator(int sort_column, Qt::SortOrder sort_order)
+{
     // Since sortIndicator calls this routine, must disconnect/reconnect while resorting
     disconnect(ui.SpellcheckEditorTree->header(), SIGNAL(sortIndicatorChanged(int, Qt::SortOrder)), this, SLOT(Sort(int, Qt::SortOrder)));
     ui.SpellcheckEditorTree->header()->setSortIndicator(sort_column, sort_order);
     connect(ui.SpellcheckEditorTree->header(), SIGNAL(sortIndicatorChanged(int, Qt::SortOrder)), this, SLOT(Sort(int, Qt::SortOrder)));
+}
 
+void SpellcheckEditor::UpdateTotals(const QHash<QString, int> &unique_words)
+{
+    int total_misspelled_words = 0;
+    foreach(QString word, unique_words.keys()) {
+        if (m_Misspelled.value(word)) {
+            total_misspelled_words++;
+        }
+    }
 
     ui.SpellcheckEditorTree->header()->setToolTip("<table><tr><td>" % tr("Misspelled Words") % ":</td><td>" % QString::number(total_misspelled_words) % "</td></tr><tr><td>" % tr("Total Unique Words") % ":</td><td>" % QString::number(unique_words.count()) % "</td></tr></table>");
 }
@@ -306,7 +433,18 @@ void SpellcheckEditor::Refresh(int sort_column, Qt::SortOrder sort_order)
     QApplication::setOverrideCursor(Qt::WaitCursor);
 
     WriteSettings();
-    CreateModel(sort_column, sort_order);
+
+    if (m_ModelIsCurrent) {
+        // The row to select is about to be picked again below.
+        if (m_SelectRow >= 0) {
+            ui.SpellcheckEditorTree->selectionModel()->clear();
+        }
+
+        UpdateModel(sort_column, sort_order);
+    } else {
+        CreateModel(sort_column, sort_order);
+    }
+
     UpdateDictionaries();
 
     ReadSettings();
@@ -337,6 +475,8 @@ void SpellcheckEditor::DictionaryChanged(QString dictionary)
 
 void SpellcheckEditor::ChangeState(int state)
 {
+    // The rows shown, or their kind of word items, change
+    m_ModelIsCurrent = false;
     Refresh();
 }
 
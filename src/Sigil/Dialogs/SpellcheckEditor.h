@@ -28,6 +28,7 @@
 #include <QtGui/QStandardItemModel>
 #include <QtWidgets/QAction>
 #include <QtWidgets/QMenu>
+#include <QtCore/QHash>
 #include <QtCore/QSharedPointer>
 
 #include "Misc/SettingsStore.h"
@@ -87,6 +88,30 @@ private slots:
 
 private:
     void CreateModel(int logicalindex, Qt::SortOrder order);
+
+    /**
+     * Brings the existing model up to date with the book, touching
+     * only the rows of words whose count or spelling changed.
+     */
+    void UpdateModel(int logicalindex, Qt::SortOrder order);
+
+    QList<QStandardItem *> CreateRowItems(const QString &word, int count, bool misspelled);
+    void SetSortIndicator(int logicalindex, Qt::SortOrder order);
+    void UpdateTotals(const QHash<QString, int> &unique_words);
+
+    /**
+     * Makes sure m_Misspelled holds a result for each of the words.
+     * Words not checked before are spellchecked on a worker thread.
+     */
+    void CheckSpelling(const QList<QString> &words);
+    static QHash<QString, bool> SpellcheckWords(const QList<QString> &words);
+
+    /**
+     * Records that the user told the spellchecker to accept the word,
+     * without discarding the rest of the cached results.
+     */
+    void AcceptWord(const QString &word, int generation_before);
+
     void UpdateDictionaries();
     void SetupSpellcheckEditorTree();
     void MarkSpelledOkay(int row);
@@ -122,6 +147,19 @@ private:
 
     int m_SelectRow;
 
+    /**
+     * Whether the rows of the model can be updated in place. They can't
+     * when there is no model yet, or the kind of rows shown changed.
+     */
+    bool m_ModelIsCurrent;
+
+    /**
+     * Whether each word seen is misspelled. Only valid while
+     * m_SpellingGeneration matches the spellchecker's generation.
+     */
+    QHash<QString, bool> m_Misspelled;
+    int m_SpellingGeneration;
+
     Ui::SpellcheckEditor ui;
 };
 
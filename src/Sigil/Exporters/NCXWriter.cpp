@@ -159,7 +159,7 @@ NCXModel::NCXEntry NCXWriter::ConvertHeadingWalker(Headings::Heading &heading)
     if (heading.include_in_toc) {
         ncx_child.text = heading.text;
         QString heading_file = heading.resource_file->GetRelativePathToOEBPS();
-        QString existing_ids = XtoQ(heading.element->getAttribute(QtoX("id"))).simplified();
+        QString existing_ids = heading.id.simplified();
         QString id_to_use = existing_ids;
         foreach(QString id, existing_ids.split(QChar(' '))) {
             if (id.startsWith(SIGIL_TOC_ID_PREFIX)) {
@@ -530,6 +530,8 @@ QStringList BookBrowser::AddExisting(bool only_multimedia, bool only_images)
     QList< Metadata::MetaElement > old_metadata = m_Book->GetMetadata();
     QStringList current_filenames = m_Book->GetFolderKeeper().GetAllFilenames();
     QStringList invalid_filenames;
+    // Files that need no import step are added as one batch
+    QStringList batch_filepaths;
     HTMLResource *current_html_resource = qobject_cast< HTMLResource * >(GetCurrentResource());
     Resource *open_resource = NULL;
     // Display progress dialog if adding several items
@@ -541,14 +543,10 @@ QStringList BookBrowser::AddExisting(bool only_multimedia, bool only_images)
         progress.setMinimumDuration(PROGRESS_BAR_MINIMUM_DURATION);
         progress.setValue(progress_value);
     }
-    foreach(QString filepath, filepaths) {
-        if (file_count > 1) {
-            // Set progress value and ensure dialog has time to display when doing extensive updates
-            // Set ahead of actual add since it can abort in several places
-            progress.setValue(progress_value++);
-            qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-        }
+    // HTML files are imported one by one after the batch
+    QStringList html_filepaths;
 
+    foreach(QString filepath, filepaths) {
         // Check if the file matches the type requested for adding
         // Only used for inserting images from disk
         if (only_images) {
@@ -606,38 +604,63 @@ QStringList BookBrowser::AddExisting(bool only_multimedia, bool only_images)
             }
         }
 
-        if (QFileInfo(filepath).fileName() == "page-map.xml") {
-            m_Book->GetFolderKeeper().AddContentFileToFolder(filepath);
-        } else if (TEXT_EXTENSIONS.contains(QFileInfo(filepath).suffix().toLower())) {
-            ImportHTML html_import(filepath);
-            XhtmlDoc::WellFormedError error = html_import.CheckValidToLoad();
+        if (QFileInfo(filepath).fileName() != "page-map.xml" &&
+            TEXT_EXTENSIONS.contains(QFileInfo(filepath).suffix().toLower())) {
+            html_filepaths.append(filepath);
+        } else {
+            // TODO: adding a CSS file should add the referenced fonts too
+            batch_filepaths.append(filepath);
+        }
+    }
 
-            if (error.line != -1) {
-                invalid_filenames << QString("%1 (line %2: %3)").arg(QDir::toNativeSeparators(filepath)).arg(error.line).arg(error.message);
-                continue;
-            }
+    // The batch goes in before the HTML imports so that their lookup of
+    // existing files finds the stylesheets and images selected with them
+    // instead of importing a second copy.
+    if (!batch_filepaths.isEmpty()) {
+        if (file_count > 1) {
+            progress.setValue(progress_value);
+            qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+        }
 
-            html_import.SetBook(m_Book, true);
-            // Since we set the Book manually,
-            // this call merely mutates our Book.
-            html_import.GetBook();
-            Resource &added_resource = m_Book->GetFolderKeeper().GetResourceByFilename(filename);
-            HTMLResource *added_html_resource = qobject_cast< HTMLResource * >(&added_resource);
-
-            if (current_html_resource && added_html_resource) {
-                m_Book->MoveResourceAfter(*added_html_resource, *current_html_resource);
-                current_html_resource = added_html_resource;
-
-                // Only open HTML files as they are likely to be edited whereas other items
-                // are likely to be inserted into or linked to the current file.
-                // Only open the first file in any added group.
-                if (!open_resource) {
-                    open_resource = &added_resource;
-                }
+        m_Book->AddExistingFiles(batch_filepaths);
+        added_files.append(batch_filepaths);
+        progress_value += batch_filepaths.count();
+    }
+
+    foreach(QString filepath, html_filepaths) {
+        if (file_count > 1) {
+            // Set progress value and ensure dialog has time to display when doing extensive updates
+            // Set ahead of actual add since it can abort in several places
+            progress.setValue(progress_value++);
+            qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+        }
+
+        QString filename = QFileInfo(filepath).fileName();
+        ImportHTML html_import(filepath);
+        XhtmlDoc::WellFormedError error = html_import.CheckValidToLoad();
+
+        if (error.line != -1) {
+            invalid_filenames << QString("%1 (line %2: %3)").arg(QDir::toNativeSeparators(filepath)).arg(error.line).arg(error.message);
+            continue;
+        }
+
+        html_import.SetBook(m_Book, true);
+        // Since we set the Book manually,
+        // this call merely mutates our Book.
+        html_import.GetBook();
+        Resource &added_resource = m_Book->GetFolderKeeper().GetResourceByFilename(filename);
+        HTMLResource *added_html_resource = qobject_cast< HTMLResource * >(&added_resource);
+
+        if (current_html_resource && added_html_resource) {
+            m_Book->MoveResourceAfter(*added_html_resource, *current_html_resource);
+            current_html_resource = added_html_resource;
+
+            // Only open HTML files as they are likely to be edited whereas other items
+            // are likely to be inserted into or linked to the current file.
+            // Only open the first file in any added group.
+            if (!open_resource) {
+                open_resource = &added_resource;
             }
-        } else {
-            // TODO: adding a CSS file should add the referenced fonts too
-            m_Book->GetFolderKeeper().AddContentFileToFolder(filepath);
         }
 
         added_files.append(filepath);
@@ -49,7 +49,10 @@ FindReplace::FindReplace(MainWindow &main_window)
       m_OptionWrap(true),
       m_SpellCheck(false),
       m_LookWhereCurrentFile(false),
-      m_IsSearchGroupRunning(false)
+      m_IsSearchGroupRunning(false),
+      m_LoadedFileDirection(Searchable::Direction_Down),
+      m_LoadedFileSpellCheck(false),
+      m_LoadedFileHasFocus(false)
 {
     ui.setupUi(this);
     FindReplaceQLineEdit *find_ledit = new FindReplaceQLineEdit(this);
@@ -785,28 +788,21 @@ bool FindReplace::FindInAllFiles(Searchable::Direction direction)
         Resource *containing_resource = GetNextContainingHTMLResource(direction);
 
         if (containing_resource) {
+            m_LoadedFileSearchRegex = GetSearchRegex();
+            m_LoadedFileDirection = direction;
+            m_LoadedFileSpellCheck = m_SpellCheck;
             // Save if editor or F&R has focus
-            bool has_focus = HasFocus();
+            m_LoadedFileHasFocus = HasFocus();
             // Save selected resources since opening tabs changes selection
-            QList<Resource *>selected_resources = GetHTMLFiles();
+            m_LoadedFileSelectedResources.clear();
 
-            m_MainWindow.OpenResourceAndWaitUntilLoaded(*containing_resource);
-
-            // Restore selection since opening tabs changes selection
             if (GetLookWhere() == FindReplace::LookWhere_SelectedHTMLFiles && !m_SpellCheck) {
-                m_MainWindow.SelectResources(selected_resources);
-            }
-
-            // Reset focus to F&R if it had it
-            if (has_focus) {
-                SetFocus();
+                m_LoadedFileSelectedResources = GetHTMLFiles();
             }
 
-            searchable = GetAvailableSearchable();
-
-            if (searchable) {
-                found = searchable->FindNext(GetSearchRegex(), direction, m_SpellCheck, true, false);
-            }
+            m_MainWindow.OpenResourceAndCallWhenLoaded(*containing_resource, this, SLOT(FindInLoadedFile()));
+            // We only open files that contain a match.
+            found = true;
         } else {
             if (searchable) {
                 // Check the part of the original file above the cursor
@@ -818,6 +814,26 @@ bool FindReplace::FindInAllFiles(Searchable::Direction direction)
     return found;
 }
 
+void FindReplace::FindInLoadedFile()
+{
+    // Restore selection since opening tabs changes selection
+    if (!m_LoadedFileSelectedResources.isEmpty()) {
+        m_MainWindow.SelectResources(m_LoadedFileSelectedResources);
+        m_LoadedFileSelectedResources.clear();
+    }
+
+    // Reset focus to F&R if it had it
+    if (m_LoadedFileHasFocus) {
+        SetFocus();
+    }
+
+    Searchable *searchable = GetAvailableSearchable();
+
+    if (!searchable || !searchable->FindNext(m_LoadedFileSearchRegex, m_LoadedFileDirection, m_LoadedFileSpellCheck, true, false)) {
+        CannotFindSearchTerm();
+    }
+}
+
 HTMLResource *FindReplace::GetNextContainingHTMLResource(Searchable::Direction direction)
 {
     Resource *current_resource = GetCurrentResource();
@@ -170,6 +170,10 @@ private slots:
 
     void AdvancedOptionsClicked();
 
+    // Finds the match in the file FindInAllFiles opened,
+    // once its tab has loaded.
+    void FindInLoadedFile();
+
 private:
     Searchable::Direction GetSearchableDirection();
     bool FindText(Searchable::Direction direction);
@@ -306,6 +310,14 @@ private:
     QString m_LastFindText;
 
     bool m_IsSearchGroupRunning;
+
+    // The search FindInLoadedFile runs, saved when the file is opened
+    // since the options may be changed back before the tab has loaded.
+    QString m_LoadedFileSearchRegex;
+    Searchable::Direction m_LoadedFileDirection;
+    bool m_LoadedFileSpellCheck;
+    bool m_LoadedFileHasFocus;
+    QList<Resource *> m_LoadedFileSelectedResources;
 };
 
 
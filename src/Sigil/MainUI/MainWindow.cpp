@@ -22,6 +22,7 @@
 *************************************************************************/
 
 #include <QtCore/QFileInfo>
+#include <QtCore/QMetaMethod>
 #include <QtCore/QSignalMapper>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
@@ -70,11 +71,11 @@
 #include "Misc/HTMLSpellCheck.h"
 #include "Misc/KeyboardShortcutManager.h"
 #include "Misc/SettingsStore.h"
-#include "Misc/SleepFunctions.h"
 #include "Misc/SpellCheck.h"
 #include "Misc/TOCHTMLWriter.h"
 #include "Misc/Utility.h"
 #include "MiscEditors/IndexHTMLWriter.h"
+#include "ResourceObjects/CSSResource.h"
 #include "ResourceObjects/HTMLResource.h"
 #include "ResourceObjects/NCXResource.h"
 #include "ResourceObjects/OPFResource.h"
@@ -166,7 +167,8 @@ MainWindow::MainWindow(const QString &openfilepath, QWidget *parent, Qt::WindowF
     m_PreviousHTMLResource(NULL),
     m_PreviousHTMLText(QString()),
     m_PreviousHTMLLocation(QList<ViewEditor::ElementIndex>()),
-    m_SaveCSS(false)
+    m_SaveCSS(false),
+    m_FoundWordPosition(-1)
 {
     ui.setupUi(this);
 
@@ -360,18 +362,56 @@ void MainWindow::OpenResource(Resource &resource,
     }
 }
 
-void MainWindow::OpenResourceAndWaitUntilLoaded(Resource &resource,
+void MainWindow::OpenResourceAndCallWhenLoaded(Resource &resource,
+                              QObject *receiver,
+                              const char *member,
                               int line_to_scroll_to,
-                              int position_to_scroll_to,
-                              const QString &caret_location_to_scroll_to,
-                              MainWindow::ViewState view_state,
-                              const QUrl &fragment,
-                              bool precede_current_tab)
+                              int position_to_scroll_to)
 {
-    OpenResource(resource, line_to_scroll_to, position_to_scroll_to, caret_location_to_scroll_to, view_state, fragment, precede_current_tab);
-    while (!GetCurrentContentTab().IsLoadingFinished()) {
-        qApp->processEvents();
-        SleepFunctions::msleep(100);
+    // SLOT() prefixes the signature with a code we do not need.
+    m_LoadedReceiver = receiver;
+    m_LoadedMember = QMetaObject::normalizedSignature(member + 1);
+    OpenResource(resource, line_to_scroll_to, position_to_scroll_to);
+    ContentTab &tab = GetCurrentContentTab();
+
+    if (tab.IsLoadingFinished()) {
+        CallWhenLoadedMember();
+    } else {
+        connect(&tab, SIGNAL(LoadingFinished()), this, SLOT(CurrentTabLoaded()), Qt::UniqueConnection);
+    }
+}
+
+void MainWindow::CurrentTabLoaded()
+{
+    ContentTab *tab = qobject_cast< ContentTab * >(sender());
+
+    if (tab) {
+        disconnect(tab, SIGNAL(LoadingFinished()), this, SLOT(CurrentTabLoaded()));
+
+        // The user has moved on to another tab, which will
+        // answer for itself if we are waiting on it.
+        if (tab != &GetCurrentContentTab()) {
+            return;
+        }
+    }
+
+    CallWhenLoadedMember();
+}
+
+void MainWindow::CallWhenLoadedMember()
+{
+    if (!m_LoadedReceiver) {
+        return;
+    }
+
+    // Clear the request first so the slot can open another resource.
+    QObject *receiver = m_LoadedReceiver;
+    int index = receiver->metaObject()->indexOfMethod(m_LoadedMember.constData());
+    m_LoadedReceiver = NULL;
+    m_LoadedMember.clear();
+
+    if (index != -1) {
+        receiver->metaObject()->method(index).invoke(receiver, Qt::DirectConnection);
     }
 }
 
@@ -481,6 +521,8 @@ void MainWindow::closeEvent(QCloseEvent *event)
             m_SpellcheckEditor->ForceClose();
         }
 
+        // The reports may still be gathering data from the book.
+        m_Reports->WaitForReports();
         event->accept();
     } else {
         event->ignore();
@@ -974,7 +1016,12 @@ void MainWindow::AddCover()
     m_BookBrowser->Refresh();
     m_Book->SetModified();
     QWebSettings::clearMemoryCaches();
-    OpenResourceAndWaitUntilLoaded(*html_cover_resource);
+    QApplication::restoreOverrideCursor();
+    OpenResourceAndCallWhenLoaded(*html_cover_resource, this, SLOT(AddCoverLoaded()));
+}
+
+void MainWindow::AddCoverLoaded()
+{
     // Reload the tab to ensure it reflects updated image.
     FlowTab *flow_tab = GetCurrentFlowTab();
     if (flow_tab) {
@@ -983,7 +1030,6 @@ void MainWindow::AddCover()
     }
 
     ShowMessageOnStatusBar(tr("Cover added."));
-    QApplication::restoreOverrideCursor();
 }
 
 void MainWindow::CreateIndex()
@@ -1269,8 +1315,9 @@ void MainWindow::DeleteUnusedStyles()
         return;
     }
 
-    QList<BookReports::StyleData *> html_class_usage = BookReports::GetHTMLClassUsage(m_Book, true);
-    QList<BookReports::StyleData *> css_selector_usage = BookReports::GetCSSSelectorUsage(m_Book, html_class_usage);
+    QList<BookReports::ResourceSnapshot> resources = BookReports::GetResourceSnapshots(m_Book);
+    QList<BookReports::StyleData *> html_class_usage = BookReports::GetHTMLClassUsage(resources, true);
+    QList<BookReports::StyleData *> css_selector_usage = BookReports::GetCSSSelectorUsage(resources, html_class_usage);
     QList<BookReports::StyleData *> css_selectors_to_delete;
     foreach(BookReports::StyleData * selector, css_selector_usage) {
         if (selector->html_filename.isEmpty()) {
@@ -1864,7 +1911,10 @@ void MainWindow::FindWord(QString word)
         int found_pos = HTMLSpellCheck::WordPosition(text, word, start_pos);
         if (found_pos >= 0) {
             if (resource->Filename() != current_html_filename) {
-                OpenResourceAndWaitUntilLoaded(*resource, -1, found_pos);
+                m_FoundWord = word;
+                m_FoundWordPosition = found_pos;
+                OpenResourceAndCallWhenLoaded(*resource, this, SLOT(HighlightFoundWord()), -1, found_pos);
+                break;
             }
             FlowTab *flow_tab = GetCurrentFlowTab();
             if (flow_tab) {
@@ -1875,6 +1925,14 @@ void MainWindow::FindWord(QString word)
     }
 }
 
+void MainWindow::HighlightFoundWord()
+{
+    FlowTab *flow_tab = GetCurrentFlowTab();
+    if (flow_tab) {
+        flow_tab->HighlightWord(m_FoundWord, m_FoundWordPosition);
+    }
+}
+
 void MainWindow::UpdateWord(QString old_word, QString new_word)
 {
     QApplication::setOverrideCursor(Qt::WaitCursor);
@@ -1952,6 +2010,9 @@ QStringList MainWindow::GetStylesheetsAlreadyLinked(Resource *resource)
 
 void MainWindow::RemoveResources(QList<Resource *> resources)
 {
+    // The reports may still be gathering data from the resources.
+    m_Reports->WaitForReports();
+
     // Provide the open tab list to ensure one tab stays open
     if (resources.count() > 0) {
         m_BookBrowser->RemoveResources(m_TabManager.GetTabResources(), resources);
@@ -2794,9 +2855,8 @@ void MainWindow::SetupPreviewTimer()
 
 void MainWindow::UpdatePreviewRequest()
 {
-    if (m_PreviewTimer.isActive()) {
-         m_PreviewTimer.stop();
-    }
+    // Restarting the timer on every request means
+    // a burst of edits only produces a single refresh.
     m_PreviewTimer.start();
 }
 
@@ -2856,11 +2916,46 @@ void MainWindow::UpdatePreview()
             m_PreviousHTMLText = text;
             m_PreviousHTMLLocation = location;
 
-            m_PreviewWindow->UpdatePage(html_resource->GetFullPath(), text, location);
+            if (!m_PreviewWindow->IsVisible()) {
+                return;
+            }
+
+            // The strings are implicitly shared, so comparing them is cheap
+            // and only scans the text when the lengths match.
+            QString path = html_resource->GetFullPath();
+            QList< QPair< QString, int > > stylesheet_revisions = GetStylesheetRevisions();
+
+            if (path == m_PreviewedPath &&
+                text == m_PreviewedText &&
+                stylesheet_revisions == m_PreviewedStylesheetRevisions) {
+                if (location != m_PreviewedLocation) {
+                    m_PreviewedLocation = location;
+                    m_PreviewWindow->UpdateLocation(location);
+                }
+
+                return;
+            }
+
+            m_PreviewedPath = path;
+            m_PreviewedText = text;
+            m_PreviewedStylesheetRevisions = stylesheet_revisions;
+            m_PreviewedLocation = location;
+            m_PreviewWindow->UpdatePage(path, text, location);
         }
     }
 }
 
+QList< QPair< QString, int > > MainWindow::GetStylesheetRevisions()
+{
+    QList< QPair< QString, int > > revisions;
+    foreach(CSSResource * css_resource, m_Book->GetFolderKeeper().GetResourceTypeList< CSSResource >()) {
+        revisions.append(qMakePair(css_resource->GetIdentifier(), css_resource->GetRevision()));
+    }
+    // The resources come in no particular order
+    qSort(revisions);
+    return revisions;
+}
+
 void MainWindow::InspectHTML()
 {
     m_PreviewWindow->show();
@@ -3018,7 +3113,7 @@ void MainWindow::SplitOnSGFSectionMarkers()
     QList<Resource *> *changed_resources = new QList<Resource *>();
     foreach(Resource * resource, html_resources) {
         HTMLResource *html_resource = qobject_cast<HTMLResource *>(resource);
-        QStringList new_sections = html_resource->SplitOnSGFSectionMarkers();
+        XhtmlDoc::SGFSectionSplits new_sections = html_resource->SplitOnSGFSectionMarkers();
 
         if (!new_sections.isEmpty()) {
             m_Book->CreateNewSections(new_sections, *html_resource);
@@ -3165,6 +3260,8 @@ bool MainWindow::MaybeSaveDialogSaysProceed()
 
 void MainWindow::SetNewBook(QSharedPointer< Book > new_book)
 {
+    // The reports may still be gathering data from the old book.
+    m_Reports->WaitForReports();
     m_TabManager.CloseOtherTabs();
     m_TabManager.CloseAllTabs(true);
     m_Book = new_book;
@@ -3325,7 +3422,7 @@ bool MainWindow::SaveFile(const QString &fullfilepath, bool update_current_filen
             HTMLResource *t = dynamic_cast<HTMLResource *>(r);
             if (t) {
                 resources.append(t);
-                if (!XhtmlDoc::IsDataWellFormed(t->GetText())) {
+                if (!t->FileIsWellFormed()) {
                     not_well_formed = true;
                     break;
                 }
@@ -3344,11 +3441,17 @@ bool MainWindow::SaveFile(const QString &fullfilepath, bool update_current_filen
                             QMessageBox::Yes|QMessageBox::No);
                 QApplication::setOverrideCursor(Qt::WaitCursor);
                 if (auto_fix) {
-                    CleanSource::ReformatAll(resources, CleanSource::Clean);
+                    if (!CleanSource::ReformatAll(resources, CleanSource::Clean)) {
+                        ShowMessageOnStatusBar(tr("Save cancelled."));
+                        QApplication::restoreOverrideCursor();
+                        return false;
+                    }
                     not_well_formed = false;
                 }
-            } else {
-                CleanSource::ReformatAll(resources, CleanSource::Clean);
+            } else if (!CleanSource::ReformatAll(resources, CleanSource::Clean)) {
+                ShowMessageOnStatusBar(tr("Save cancelled."));
+                QApplication::restoreOverrideCursor();
+                return false;
             }
         }
         
@@ -25,6 +25,8 @@
 #ifndef SIGIL_H
 #define SIGIL_H
 
+#include <QtCore/QPair>
+#include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
 #include <QtWidgets/QMainWindow>
 
@@ -196,13 +198,19 @@ public slots:
                       const QUrl &fragment = QUrl(),
                       bool precede_current_tab = false);
 
-    void OpenResourceAndWaitUntilLoaded(Resource &resource,
+    /**
+     * Opens the specified resource and calls the \a member slot of
+     * \a receiver once its tab has finished loading. The slot is called
+     * immediately if the tab is already loaded.
+     *
+     * Only the latest request is answered: opening another resource this way
+     * before the tab has loaded drops the earlier call.
+     */
+    void OpenResourceAndCallWhenLoaded(Resource &resource,
+                      QObject *receiver,
+                      const char *member,
                       int line_to_scroll_to = -1,
-                      int position_to_scroll_to = -1,
-                      const QString &caret_location_to_scroll_to = QString(),
-                      MainWindow::ViewState view_state = MainWindow::ViewState_Unknown,
-                      const QUrl &fragment = QUrl(),
-                      bool precede_current_tab = false);
+                      int position_to_scroll_to = -1);
 
     void CreateIndex();
 
@@ -230,6 +238,23 @@ private slots:
 
     void AddCover();
 
+    /**
+     * Reloads the cover tab once AddCover has opened it.
+     */
+    void AddCoverLoaded();
+
+    /**
+     * Calls the slot passed to OpenResourceAndCallWhenLoaded
+     * if the current tab has finished loading.
+     */
+    void CurrentTabLoaded();
+
+    /**
+     * Highlights the word FindWord found in another file
+     * once that file has been opened.
+     */
+    void HighlightFoundWord();
+
     /**
      * Implements New action functionality.
      */
@@ -611,6 +636,11 @@ private slots:
     void UpdateClipsUI();
 
 private:
+    /**
+     * Calls the slot passed to OpenResourceAndCallWhenLoaded, once.
+     */
+    void CallWhenLoadedMember();
+
     void UpdateClipButton(int clip_number, QAction *ui_action);
     void InsertFiles(const QStringList &selected_images);
     void InsertFilesFromDisk();
@@ -800,6 +830,13 @@ private:
 
     void SetupPreviewTimer();
 
+    /**
+     * Returns the identifier and text revision of every stylesheet in
+     * the book, sorted. The list changes whenever a stylesheet is added,
+     * removed or edited. Used to tell if the Preview is stale.
+     */
+    QList< QPair< QString, int > > GetStylesheetRevisions();
+
     ///////////////////////////////
     // PRIVATE MEMBER VARIABLES
     ///////////////////////////////
@@ -966,8 +1003,29 @@ private:
     QString m_PreviousHTMLText;
     QList<ViewEditor::ElementIndex> m_PreviousHTMLLocation;
 
+    /**
+     * What the Preview currently shows, so unchanged content isn't resent.
+     */
+    QString m_PreviewedPath;
+    QString m_PreviewedText;
+    QList< QPair< QString, int > > m_PreviewedStylesheetRevisions;
+    QList<ViewEditor::ElementIndex> m_PreviewedLocation;
+
     bool m_SaveCSS;
 
+    /**
+     * The slot to call once the tab opened by
+     * OpenResourceAndCallWhenLoaded has loaded.
+     */
+    QPointer< QObject > m_LoadedReceiver;
+    QByteArray m_LoadedMember;
+
+    /**
+     * The word FindWord found in another file, and where.
+     */
+    QString m_FoundWord;
+    int m_FoundWordPosition;
+
     /**
      * Holds all the widgets Qt Designer created for us.
      */
@@ -33,6 +33,8 @@ NCXModel::NCXModel(QObject *parent)
     QStandardItemModel(parent),
     m_Book(NULL),
     m_RefreshInProgress(false),
+    m_RefreshRevision(-1),
+    m_ModelRevision(-1),
     m_NcxRootWatcher(*new QFutureWatcher< NCXModel::NCXEntry >(this))
 {
     connect(&m_NcxRootWatcher, SIGNAL(finished()), this, SLOT(RefreshEnd()));
@@ -46,6 +48,9 @@ void NCXModel::SetBook(QSharedPointer< Book > book)
         QMutexLocker book_lock(&m_UsingBookMutex);
         m_Book = book;
     }
+    // Nothing of the previous book's model can be reused
+    clear();
+    m_ModelRevision = -1;
     Refresh();
 }
 
@@ -74,6 +79,13 @@ void NCXModel::Refresh()
         return;
     }
 
+    // Read before the text is, so a change in between triggers another refresh
+    m_RefreshRevision = m_Book->GetNCX().GetRevision();
+
+    if (m_RefreshRevision == m_ModelRevision) {
+        return;
+    }
+
     m_RefreshInProgress = true;
     m_NcxRootWatcher.setFuture(QtConcurrent::run(this, &NCXModel::GetRootNCXEntry));
 }
@@ -81,9 +93,24 @@ void NCXModel::Refresh()
 
 void NCXModel::RefreshEnd()
 {
-    BuildModel(m_NcxRootWatcher.result());
+    QList< QStandardItem * > added_items = BuildModel(m_NcxRootWatcher.result());
+    m_ModelRevision = m_RefreshRevision;
     m_RefreshInProgress = false;
+
+    if (!added_items.isEmpty()) {
+        QList< QModelIndex > indexes;
+        foreach(QStandardItem * item, added_items) {
+            indexes.append(item->index());
+        }
+        emit ItemsAdded(indexes);
+    }
+
     emit RefreshDone();
+
+    // Refresh calls made while we were busy were dropped
+    if (m_Book->GetNCX().GetRevision() != m_ModelRevision) {
+        Refresh();
+    }
 }
 
 
@@ -171,16 +198,97 @@ NCXModel::NCXEntry NCXModel::ParseNavPoint(QXmlStreamReader &ncx)
 }
 
 
-void NCXModel::BuildModel(const NCXModel::NCXEntry &root_entry)
+QList< QStandardItem * > NCXModel::BuildModel(const NCXModel::NCXEntry &root_entry)
 {
-    clear();
-    foreach(const NCXModel::NCXEntry & child_entry, root_entry.children) {
-        AddEntryToParentItem(child_entry, invisibleRootItem());
+    QList< QStandardItem * > added_items;
+    UpdateChildItems(root_entry.children, invisibleRootItem(), added_items);
+    return added_items;
+}
+
+
+void NCXModel::UpdateChildItems(const QList< NCXEntry > &entries,
+                                QStandardItem *parent,
+                                QList< QStandardItem * > &added_items)
+{
+    Q_ASSERT(parent);
+    int num_entries = entries.count();
+    int row = 0;
+
+    for (int i = 0; i < num_entries; ++i) {
+        const NCXModel::NCXEntry &entry = entries.at(i);
+
+        if (row < parent->rowCount() && parent->child(row)->toolTip() != entry.target) {
+            int matching_row = FindRowWithTarget(entry.target, parent, row + 1);
+
+            if (matching_row != -1) {
+                // The rows before the one for this entry were removed
+                parent->removeRows(row, matching_row - row);
+            } else if (FindEntryWithTarget(parent->child(row)->toolTip(), entries, i + 1) != -1) {
+                // The row belongs to a later entry, so this one is new
+                AddEntryToParentItem(entry, parent, row++, added_items);
+                continue;
+            }
+
+            // Otherwise the entry was edited and keeps its row
+        }
+
+        if (row >= parent->rowCount()) {
+            AddEntryToParentItem(entry, parent, row++, added_items);
+            continue;
+        }
+
+        QStandardItem *item = parent->child(row++);
+        UpdateItem(entry, item);
+        UpdateChildItems(entry.children, item, added_items);
     }
+
+    if (parent->rowCount() > row) {
+        parent->removeRows(row, parent->rowCount() - row);
+    }
+}
+
+
+int NCXModel::FindRowWithTarget(const QString &target, const QStandardItem *parent, int from_row)
+{
+    for (int row = from_row; row < parent->rowCount(); ++row) {
+        if (parent->child(row)->toolTip() == target) {
+            return row;
+        }
+    }
+
+    return -1;
+}
+
+
+int NCXModel::FindEntryWithTarget(const QString &target, const QList< NCXEntry > &entries, int from_index)
+{
+    for (int i = from_index; i < entries.count(); ++i) {
+        if (entries.at(i).target == target) {
+            return i;
+        }
+    }
+
+    return -1;
 }
 
 
-void NCXModel::AddEntryToParentItem(const NCXEntry &entry, QStandardItem *parent)
+void NCXModel::UpdateItem(const NCXEntry &entry, QStandardItem *item)
+{
+    if (item->text() != entry.text) {
+        item->setText(entry.text);
+    }
+
+    if (item->toolTip() != entry.target) {
+        item->setData(QUrl(entry.target));
+        item->setToolTip(entry.target);
+    }
+}
+
+
+void NCXModel::AddEntryToParentItem(const NCXEntry &entry,
+                                    QStandardItem *parent,
+                                    int row,
+                                    QList< QStandardItem * > &added_items)
 {
     Q_ASSERT(parent);
     QStandardItem *item = new QStandardItem(entry.text);
@@ -189,9 +297,14 @@ void NCXModel::AddEntryToParentItem(const NCXEntry &entry, QStandardItem *parent
     item->setEditable(false);
     item->setDragEnabled(false);
     item->setDropEnabled(false);
-    parent->appendRow(item);
+    parent->insertRow(row, item);
+
+    if (!entry.children.isEmpty()) {
+        added_items.append(item);
+    }
+
     foreach(const NCXModel::NCXEntry & child_entry, entry.children) {
-        AddEntryToParentItem(child_entry, item);
+        AddEntryToParentItem(child_entry, item, item->rowCount(), added_items);
     }
 }
 
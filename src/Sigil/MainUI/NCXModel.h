@@ -78,6 +78,7 @@ public:
      * done in a separate thread. The "second part" of this process is
      * in RefreshEnd.
      * Can be called repeatedly while a refresh is still in progress.
+     * Does nothing if the NCX has not changed since the last refresh.
      */
     void Refresh();
 
@@ -122,8 +123,16 @@ public:
     NCXEntry GetRootNCXEntry();
 
 signals:
+
     void RefreshDone();
 
+    /**
+     * Emitted when a refresh added items to the model.
+     *
+     * @param indexes The indexes of the new items that have children.
+     */
+    void ItemsAdded(const QList< QModelIndex > &indexes);
+
 private slots:
 
     /**
@@ -160,17 +169,51 @@ private:
     static NCXEntry ParseNavPoint(QXmlStreamReader &ncx);
 
     /**
-     * Builds the actual display model from the tree of NCXEntries.
+     * Brings the display model in line with the tree of NCXEntries.
+     * Only the rows that differ are changed, so the views keep
+     * their scroll position and expanded items.
      *
      * @param root_entry The root NCX entry.
+     * @return The new items that have children.
+     */
+    QList< QStandardItem * > BuildModel(const NCXEntry &root_entry);
+
+    /**
+     * Updates the children of the parent item to match the
+     * entries, recursively. Rows are matched to entries by their target,
+     * so inserted and removed entries only insert and remove their own rows.
+     * New items that have children are appended to added_items.
+     */
+    static void UpdateChildItems(const QList< NCXEntry > &entries,
+                                 QStandardItem *parent,
+                                 QList< QStandardItem * > &added_items);
+
+    /**
+     * Returns the first row of the parent, starting at from_row,
+     * whose item points to the target, or -1 if there is none.
+     */
+    static int FindRowWithTarget(const QString &target, const QStandardItem *parent, int from_row);
+
+    /**
+     * Returns the index of the first entry, starting at from_index,
+     * that points to the target, or -1 if there is none.
+     */
+    static int FindEntryWithTarget(const QString &target, const QList< NCXEntry > &entries, int from_index);
+
+    /**
+     * Sets the text and target of the item if they changed.
      */
-    void BuildModel(const NCXEntry &root_entry);
+    static void UpdateItem(const NCXEntry &entry, QStandardItem *item);
 
     /**
-     * Adds the provided entry as an item child to the provided parent.
-     * Calls itself recursively if the entry has children of it's own.
+     * Inserts the provided entry as an item child of the provided parent
+     * at the given row. Calls itself recursively if the entry has children
+     * of it's own; the items that get children are appended to added_items.
      */
-    static void AddEntryToParentItem(const NCXEntry &entry, QStandardItem *parent);
+    static void AddEntryToParentItem(const NCXEntry &entry,
+                                     QStandardItem *parent,
+                                     int row,
+                                     QList< QStandardItem * > &added_items);
 
 
     ///////////////////////////////
@@ -187,6 +230,13 @@ private:
      */
     bool m_RefreshInProgress;
 
+    /**
+     * The NCX text revision the running refresh started from,
+     * and the one the model currently shows (-1 for none).
+     */
+    int m_RefreshRevision;
+    int m_ModelRevision;
+
     /**
      * Guards the use of the m_Book variable.
      */
@@ -297,6 +297,12 @@ void OPFModel::RowsRemovedHandler(const QModelIndex &parent, int start, int end)
 void OPFModel::ItemChangedHandler(QStandardItem *item)
 {
     Q_ASSERT(item);
+
+    // Items updated by the model itself are not user renames
+    if (m_RefreshInProgress) {
+        return;
+    }
+
     const QString &identifier = item->data().toString();
 
     if (!identifier.isEmpty()) {
@@ -330,6 +336,7 @@ bool OPFModel:: RenameResourceList(QList<Resource *> resources, QList<QString> n
     QApplication::setOverrideCursor(Qt::WaitCursor);
     QStringList not_renamed;
     QHash< QString, QString > update;
+    QStringList old_filenames;
     foreach(Resource * resource, resources) {
         const QString &old_fullpath = resource->GetFullPath();
         QString old_filename = resource->Filename();
@@ -360,14 +367,21 @@ bool OPFModel:: RenameResourceList(QList<Resource *> resources, QList<QString> n
         }
 
         update[ old_fullpath ] = "../" + resource->GetRelativePathToOEBPS();
+        old_filenames.append(old_filename);
     }
 
     if (update.count() > 0) {
-        UniversalUpdates::PerformUniversalUpdates(true, m_Book->GetFolderKeeper().GetResourceList(), update);
+        // Only the files that reference the renamed ones need updating,
+        // along with the OPF and NCX which list every file.
+        QList< Resource * > referencing_resources = m_Book->GetResourcesReferencingFiles(old_filenames);
+        referencing_resources.append(&m_Book->GetOPF());
+        referencing_resources.append(&m_Book->GetNCX());
+        UniversalUpdates::PerformUniversalUpdates(true, referencing_resources, update);
         emit BookContentModified();
     }
 
-    Refresh();
+    // Also resets the items of the files that could not be renamed
+    UpdateItems(resources);
     QApplication::restoreOverrideCursor();
 
     if (not_renamed.isEmpty()) {
@@ -389,13 +403,7 @@ void OPFModel::InitializeModel()
         AlphanumericItem *item = new AlphanumericItem(resource->Icon(), resource->Filename());
         item->setDropEnabled(false);
         item->setData(resource->GetIdentifier());
-        QString tooltip = resource->Filename();
-        QString path = resource->GetRelativePathToOEBPS();
-
-        if (semantic_type_all.contains(path)) {
-            tooltip += " (" + semantic_type_all[path] + ")";
-        }
-        item->setToolTip(tooltip);
+        item->setToolTip(GetToolTip(resource, semantic_type_all));
 
         if (resource->Type() == Resource::HTMLResourceType) {
             int reading_order = -1;
@@ -439,6 +447,52 @@ void OPFModel::InitializeModel()
 }
 
 
+void OPFModel::UpdateItems(const QList< Resource * > &resources)
+{
+    QHash <QString, QString> semantic_type_all = m_Book->GetOPF().GetGuideSemanticNameForPaths();
+    QList< QStandardItem * > folders_to_sort;
+    m_RefreshInProgress = true;
+    foreach(Resource * resource, resources) {
+        QStandardItem *item = itemFromIndex(GetModelItemIndex(*resource, IndexChoice_Current));
+
+        if (!item || item->data().toString() != resource->GetIdentifier()) {
+            // Not a folder we can find items in, so start over
+            m_RefreshInProgress = false;
+            Refresh();
+            return;
+        }
+
+        item->setText(resource->Filename());
+        item->setToolTip(GetToolTip(resource, semantic_type_all));
+
+        if (resource->Type() == Resource::HTMLResourceType) {
+            // HTML files stay in reading order, the name only matters for sorting selections
+            QString name = resource->Filename().left(resource->Filename().lastIndexOf('.'));
+            item->setData(name, ALPHANUMERIC_ORDER_ROLE);
+        } else if (item->parent() && !folders_to_sort.contains(item->parent())) {
+            folders_to_sort.append(item->parent());
+        }
+    }
+    foreach(QStandardItem * folder, folders_to_sort) {
+        folder->sortChildren(0);
+    }
+    m_RefreshInProgress = false;
+}
+
+
+QString OPFModel::GetToolTip(Resource *resource, const QHash <QString, QString> &semantic_type_all)
+{
+    QString tooltip = resource->Filename();
+    QString path = resource->GetRelativePathToOEBPS();
+
+    if (semantic_type_all.contains(path)) {
+        tooltip += " (" + semantic_type_all[path] + ")";
+    }
+
+    return tooltip;
+}
+
+
 void OPFModel::UpdateHTMLReadingOrders()
 {
     QList< HTMLResource * > reading_order_htmls;
@@ -199,6 +199,18 @@ private:
      */
     void InitializeModel();
 
+    /**
+     * Updates the names and tooltips of the items of the given
+     * resources in place, keeping their folders sorted.
+     */
+    void UpdateItems(const QList< Resource * > &resources);
+
+    /**
+     * Returns the tooltip of a resource's item: its filename
+     * and any guide semantic type it has.
+     */
+    static QString GetToolTip(Resource *resource, const QHash <QString, QString> &semantic_type_all);
+
     /**
      * Updates the reading orders of the HTMLResources
      * with their order in the model.
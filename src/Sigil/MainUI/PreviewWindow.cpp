@@ -141,6 +141,15 @@ void PreviewWindow::UpdatePage(QString filename, QString text, QList< ViewEditor
         SleepFunctions::msleep(100);
     }
 
+    UpdateLocation(location);
+}
+
+void PreviewWindow::UpdateLocation(QList< ViewEditor::ElementIndex > location)
+{
+    if (!m_Preview->isVisible()) {
+        return;
+    }
+
     m_Preview->StoreCaretLocationUpdate(location);
     m_Preview->ExecuteCaretUpdate();
     m_Preview->InspectElement();
@@ -50,6 +50,7 @@ public:
 
 public slots:
     void UpdatePage(QString filename, QString text, QList< ViewEditor::ElementIndex > location);
+    void UpdateLocation(QList< ViewEditor::ElementIndex > location);
     void SetZoomFactor(float factor);
     void SplitterMoved(int pos, int index);
 
@@ -62,8 +62,8 @@ TableOfContents::TableOfContents(QWidget *parent)
             this,        SLOT(ItemClickedHandler(const QModelIndex &)));
     connect(&m_RefreshTimer, SIGNAL(timeout()),
             this,            SLOT(Refresh()));
-    connect(&m_NCXModel, SIGNAL(RefreshDone()),
-            this,            SLOT(ExpandAll()));
+    connect(&m_NCXModel, SIGNAL(ItemsAdded(const QList< QModelIndex > &)),
+            this,        SLOT(ExpandItems(const QList< QModelIndex > &)));
 }
 
 void TableOfContents::showEvent(QShowEvent *event)
@@ -166,6 +166,13 @@ void TableOfContents::ExpandAll()
     m_TreeView.expandAll();
 }
 
+void TableOfContents::ExpandItems(const QList< QModelIndex > &indexes)
+{
+    foreach(const QModelIndex & index, indexes) {
+        m_TreeView.expand(index);
+    }
+}
+
 void TableOfContents::contextMenuEvent(QContextMenuEvent *event)
 {
     QMenu *menu = new QMenu(this);
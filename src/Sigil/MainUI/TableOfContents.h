@@ -100,6 +100,14 @@ private slots:
 
     void ExpandAll();
 
+    /**
+     * Expands the items a refresh added, leaving
+     * the rest of the tree as the user left it.
+     *
+     * @param indexes The model indexes of the new items.
+     */
+    void ExpandItems(const QList< QModelIndex > &indexes);
+
 protected:
 
     void contextMenuEvent(QContextMenuEvent *event);
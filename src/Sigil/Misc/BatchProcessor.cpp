@@ -0,0 +1,313 @@
+/************************************************************************
+**
+**  Copyright (C) 2026  agent <agent@local>
+**
+**  This file is part of Sigil.
+**
+**  Sigil is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  Sigil is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with Sigil.  If not, see <http://www.gnu.org/licenses/>.
+**
+*************************************************************************/
+
+#include <iostream>
+#include <flightcrew.h>
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+
+#include "BookManipulation/Book.h"
+#include "BookManipulation/CleanSource.h"
+#include "BookManipulation/FolderKeeper.h"
+#include "Exporters/ExporterFactory.h"
+#include "Importers/ImporterFactory.h"
+#include "Misc/BatchProcessor.h"
+#include "Misc/SearchOperations.h"
+#include "Misc/Utility.h"
+#include "ResourceObjects/HTMLResource.h"
+#include "sigil_exception.h"
+
+namespace fc = FlightCrew;
+
+static const QString BATCH_OPTION    = "--batch";
+static const QString SPLIT_OPTION    = "--split";
+static const QString REPLACE_OPTION  = "--replace";
+static const QString REFORMAT_OPTION = "--reformat";
+static const QString VALIDATE_OPTION = "--validate";
+static const QString OUTPUT_OPTION   = "--output";
+
+static const QString REFORMAT_CLEAN  = "clean";
+static const QString REFORMAT_XHTML  = "xhtml";
+
+
+bool BatchProcessor::IsBatchRequested(const QStringList &arguments)
+{
+    return arguments.contains(BATCH_OPTION);
+}
+
+
+BatchProcessor::BatchProcessor(const QStringList &arguments)
+    :
+    m_ArgumentsValid(false),
+    m_Split(false),
+    m_Validate(false)
+{
+    m_ArgumentsValid = ParseArguments(arguments);
+}
+
+
+int BatchProcessor::Run()
+{
+    if (!m_ArgumentsValid) {
+        PrintUsage();
+        return 2;
+    }
+
+    m_TotalTimer.start();
+
+    try {
+        OpenBook();
+
+        if (m_Split) {
+            SplitOnSGFSectionMarkers();
+        }
+
+        if (!m_Replacements.isEmpty()) {
+            ReplaceInAllFiles();
+        }
+
+        if (!m_Reformat.isEmpty()) {
+            Reformat();
+        }
+
+        if (m_Validate) {
+            Validate();
+        }
+
+        if (!m_OutputPath.isEmpty()) {
+            SaveBook();
+        }
+    } catch (const ExceptionBase &exception) {
+        std::cerr << Utility::GetExceptionInfo(exception).toUtf8().constData() << std::endl;
+        return 1;
+    } catch (const QString &message) {
+        std::cerr << message.toUtf8().constData() << std::endl;
+        return 1;
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    QJsonObject report;
+    report["input"] = m_InputPath;
+    report["output"] = m_OutputPath;
+    report["phases"] = m_Phases;
+    report["total_ms"] = static_cast<double>(m_TotalTimer.elapsed());
+    std::cout << QJsonDocument(report).toJson().constData() << std::flush;
+    return 0;
+}
+
+
+bool BatchProcessor::ParseArguments(const QStringList &arguments)
+{
+    // The first argument is the program itself
+    for (int i = 1; i < arguments.count(); ++i) {
+        const QString &argument = arguments.at(i);
+
+        if (argument == BATCH_OPTION) {
+            continue;
+        } else if (argument == SPLIT_OPTION) {
+            m_Split = true;
+        } else if (argument == VALIDATE_OPTION) {
+            m_Validate = true;
+        } else if (argument == REPLACE_OPTION) {
+            if (i + 2 >= arguments.count()) {
+                return false;
+            }
+
+            m_Replacements.append(qMakePair(arguments.at(i + 1), arguments.at(i + 2)));
+            i += 2;
+        } else if (argument == REFORMAT_OPTION) {
+            if (i + 1 >= arguments.count()) {
+                return false;
+            }
+
+            m_Reformat = arguments.at(++i).toLower();
+
+            if (m_Reformat != REFORMAT_CLEAN && m_Reformat != REFORMAT_XHTML) {
+                return false;
+            }
+        } else if (argument == OUTPUT_OPTION) {
+            if (i + 1 >= arguments.count()) {
+                return false;
+            }
+
+            m_OutputPath = QFileInfo(arguments.at(++i)).absoluteFilePath();
+
+            // ExportEPUB is the only exporter we have
+            if (QFileInfo(m_OutputPath).suffix().toLower() != "epub") {
+                return false;
+            }
+        } else if (argument.startsWith("--") || !m_InputPath.isEmpty()) {
+            return false;
+        } else {
+            m_InputPath = QFileInfo(argument).absoluteFilePath();
+        }
+    }
+
+    return !m_InputPath.isEmpty() && Utility::IsFileReadable(m_InputPath);
+}
+
+
+void BatchProcessor::PrintUsage() const
+{
+    std::cerr << tr("Usage: sigil --batch <input.epub> [--split] [--replace <regex> <replacement>]...\n"
+                    "             [--reformat clean|xhtml] [--validate] [--output <output.epub>]\n"
+                    "Operations run in the order: split, replace, reformat, validate.\n"
+                    "Per-phase timings are written to stdout as JSON.").toUtf8().constData() << std::endl;
+}
+
+
+void BatchProcessor::OpenBook()
+{
+    StartPhase();
+    ImporterFactory importerFactory;
+    Importer *importer = importerFactory.GetImporter(m_InputPath);
+
+    if (!importer) {
+        throw tr("No importer for file type: %1").arg(QFileInfo(m_InputPath).suffix().toLower());
+    }
+
+    XhtmlDoc::WellFormedError error = importer->CheckValidToLoad();
+
+    if (error.line != -1) {
+        throw tr("%1 is not well formed (line %2: %3)").arg(m_InputPath).arg(error.line).arg(error.message);
+    }
+
+    m_Book = importer->GetBook();
+    // Let any delayed resource updates from the import land
+    QCoreApplication::processEvents();
+    QJsonObject details;
+    details["html_files"] = m_Book->GetFolderKeeper().GetResourceTypeList< HTMLResource >().count();
+    details["warnings"] = QJsonArray::fromStringList(importer->GetLoadWarnings());
+    EndPhase("import", details);
+}
+
+
+void BatchProcessor::SplitOnSGFSectionMarkers()
+{
+    StartPhase();
+    int split_files = 0;
+    foreach(HTMLResource * html_resource, m_Book->GetFolderKeeper().GetResourceTypeList< HTMLResource >(true)) {
+        // Same rule as the GUI: never split a file that is not well formed
+        if (!html_resource->FileIsWellFormed()) {
+            continue;
+        }
+
+        XhtmlDoc::SGFSectionSplits new_sections = html_resource->SplitOnSGFSectionMarkers();
+
+        if (!new_sections.isEmpty()) {
+            m_Book->CreateNewSections(new_sections, *html_resource);
+            split_files++;
+        }
+    }
+    QCoreApplication::processEvents();
+    QJsonObject details;
+    details["split_files"] = split_files;
+    EndPhase("split", details);
+}
+
+
+void BatchProcessor::ReplaceInAllFiles()
+{
+    StartPhase();
+    QList< Resource * > resources = m_Book->GetFolderKeeper().GetResourceTypeAsGenericList< HTMLResource >(true);
+    int count = 0;
+
+    for (int i = 0; i < m_Replacements.count(); ++i) {
+        count += SearchOperations::ReplaceInAllFIles(m_Replacements.at(i).first,
+                 m_Replacements.at(i).second,
+                 resources,
+                 SearchOperations::CodeViewSearch);
+    }
+
+    QCoreApplication::processEvents();
+    QJsonObject details;
+    details["replacements"] = count;
+    EndPhase("replace", details);
+}
+
+
+void BatchProcessor::Reformat()
+{
+    StartPhase();
+    QList< HTMLResource * > resources = m_Book->GetFolderKeeper().GetResourceTypeList< HTMLResource >(true);
+    // There is no main window to show the progress dialog over
+    bool reformatted = CleanSource::ReformatAll(resources,
+                       m_Reformat == REFORMAT_XHTML ? CleanSource::ToValidXHTML : CleanSource::Clean,
+                       false);
+
+    if (!reformatted) {
+        throw tr("Reformatting the HTML files failed");
+    }
+
+    QCoreApplication::processEvents();
+    QJsonObject details;
+    details["mode"] = m_Reformat;
+    EndPhase("reformat", details);
+}
+
+
+void BatchProcessor::Validate()
+{
+    StartPhase();
+    m_Book->SaveAllResourcesToDisk();
+    std::vector< fc::Result > results = fc::ValidateEpubRootFolder(
+            m_Book->GetFolderKeeper().GetFullPathToMainFolder().toUtf8().constData());
+    int errors = 0;
+    int warnings = 0;
+
+    for (unsigned int i = 0; i < results.size(); ++i) {
+        if (results[ i ].GetResultType() == fc::ResultType_WARNING) {
+            warnings++;
+        } else {
+            errors++;
+        }
+    }
+
+    QJsonObject details;
+    details["errors"] = errors;
+    details["warnings"] = warnings;
+    EndPhase("validate", details);
+}
+
+
+void BatchProcessor::SaveBook()
+{
+    StartPhase();
+    ExporterFactory().GetExporter(m_OutputPath, m_Book).WriteBook();
+    EndPhase("export");
+}
+
+
+void BatchProcessor::StartPhase()
+{
+    m_PhaseTimer.start();
+}
+
+
+void BatchProcessor::EndPhase(const QString &name, QJsonObject details)
+{
+    details["name"] = name;
+    details["ms"] = static_cast<double>(m_PhaseTimer.elapsed());
+    m_Phases.append(details);
+}
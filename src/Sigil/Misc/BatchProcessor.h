@@ -0,0 +1,124 @@
+/************************************************************************
+**
+**  Copyright (C) 2026  agent <agent@local>
+**
+**  This file is part of Sigil.
+**
+**  Sigil is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  Sigil is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with Sigil.  If not, see <http://www.gnu.org/licenses/>.
+**
+*************************************************************************/
+
+#pragma once
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPair>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+class Book;
+
+/**
+ * Runs Sigil's book pipelines without the main window, so they can be
+ * profiled and regression tested from scripts (use QT_QPA_PLATFORM=offscreen
+ * on machines without a display).
+ *
+ * The book is opened, the requested operations are run in a fixed order
+ * (split, replace, reformat, validate) and the book is saved. The time
+ * taken by each phase is written to stdout as a JSON object.
+ *
+ * Usage:
+ *   sigil --batch <input.epub> [--split] [--replace <regex> <replacement>]...
+ *         [--reformat clean|xhtml] [--validate] [--output <output.epub>]
+ */
+class BatchProcessor
+{
+    Q_DECLARE_TR_FUNCTIONS(BatchProcessor)
+
+public:
+
+    /**
+     * Returns whether the command line asks for a batch run.
+     */
+    static bool IsBatchRequested(const QStringList &arguments);
+
+    BatchProcessor(const QStringList &arguments);
+
+    /**
+     * Runs the batch.
+     *
+     * @return The process exit code.
+     */
+    int Run();
+
+private:
+
+    bool ParseArguments(const QStringList &arguments);
+
+    void PrintUsage() const;
+
+    void OpenBook();
+    void SplitOnSGFSectionMarkers();
+    void ReplaceInAllFiles();
+    void Reformat();
+    void Validate();
+    void SaveBook();
+
+    /**
+     * Starts timing a new phase.
+     */
+    void StartPhase();
+
+    /**
+     * Records the time taken by the current phase along with any
+     * phase specific details.
+     */
+    void EndPhase(const QString &name, QJsonObject details = QJsonObject());
+
+
+    ///////////////////////////////
+    // PRIVATE MEMBER VARIABLES
+    ///////////////////////////////
+
+    bool m_ArgumentsValid;
+
+    QString m_InputPath;
+    QString m_OutputPath;
+
+    bool m_Split;
+    bool m_Validate;
+
+    /**
+     * Either empty, "clean" or "xhtml".
+     */
+    QString m_Reformat;
+
+    /**
+     * The search regex and replacement text of every --replace.
+     */
+    QList< QPair< QString, QString > > m_Replacements;
+
+    QSharedPointer< Book > m_Book;
+
+    QElapsedTimer m_PhaseTimer;
+    QElapsedTimer m_TotalTimer;
+
+    QJsonArray m_Phases;
+};
+
+#endif // BATCHPROCESSOR_H
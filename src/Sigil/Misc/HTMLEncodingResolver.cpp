@@ -20,6 +20,11 @@
 **
 *************************************************************************/
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIGIL_HAVE_SSE2
+#endif
+
 #include <QtCore/QFile>
 #include <QtCore/QString>
 #include <QtCore/QTextCodec>
@@ -136,6 +141,86 @@ const QTextCodec *HTMLEncodingResolver::GetCodecForHTML(const QByteArray &raw_te
 }
 
 
+static const int ASCII_BLOCK_SIZE = 16;
+
+// Returns true if the ASCII_BLOCK_SIZE bytes starting at bytes are
+// all ASCII characters that IsValidUtf8 accepts: printable characters,
+// tab, line feed and carriage return.
+static bool IsAsciiBlock(const unsigned char *bytes)
+{
+#ifdef SIGIL_HAVE_SSE2
+    __m128i block = _mm_loadu_si128(reinterpret_cast< const __m128i * >(bytes));
+    // Bytes of 0x80 and up are negative in a signed compare, so they fail the first test
+    __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(0x1F)),
+                                      _mm_cmplt_epi8(block, _mm_set1_epi8(0x7F)));
+    __m128i whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(0x09)),
+                                                   _mm_cmpeq_epi8(block, _mm_set1_epi8(0x0A))),
+                                      _mm_cmpeq_epi8(block, _mm_set1_epi8(0x0D)));
+    return _mm_movemask_epi8(_mm_or_si128(printable, whitespace)) == 0xFFFF;
+#else
+    // Checking the whole block before branching lets the compiler vectorize this
+    bool is_ascii = true;
+
+    for (int i = 0; i < ASCII_BLOCK_SIZE; ++i) {
+        unsigned char byte = bytes[ i ];
+        is_ascii &= (0x20 <= byte && byte <= 0x7E) || byte == 0x09 || byte == 0x0A || byte == 0x0D;
+    }
+
+    return is_ascii;
+#endif
+}
+
+
+// Returns the length of the UTF-8 sequence at the start
+// of the four bytes, or 0 if they do not start with one.
+static int Utf8SequenceLength(const unsigned char *bytes)
+{
+    // ASCII
+    if (bytes[0] == 0x09 ||
+        bytes[0] == 0x0A ||
+        bytes[0] == 0x0D ||
+        (0x20 <= bytes[0] && bytes[0] <= 0x7E)
+       ) {
+        return 1;
+    }
+    // non-overlong 2-byte
+    else if ((0xC2 <= bytes[0] && bytes[0] <= 0xDF) &&
+             (0x80 <= bytes[1] && bytes[1] <= 0xBF)
+            ) {
+        return 2;
+    } else if ((bytes[0] == 0xE0                         &&              // excluding overlongs
+                (0xA0 <= bytes[1] && bytes[1] <= 0xBF) &&
+                (0x80 <= bytes[2] && bytes[2] <= 0xBF)) ||
+               (((0xE1 <= bytes[0] && bytes[0] <= 0xEC) ||               // straight 3-byte
+                 bytes[0] == 0xEE                         ||
+                 bytes[0] == 0xEF) &&
+                (0x80 <= bytes[1] && bytes[1] <= 0xBF)   &&
+                (0x80 <= bytes[2] && bytes[2] <= 0xBF)) ||
+               (bytes[0] == 0xED                         &&              // excluding surrogates
+                (0x80 <= bytes[1] && bytes[1] <= 0x9F) &&
+                (0x80 <= bytes[2] && bytes[2] <= 0xBF))
+              ) {
+        return 3;
+    } else if ((bytes[0] == 0xF0                         &&              // planes 1-3
+                (0x90 <= bytes[1] && bytes[1] <= 0xBF) &&
+                (0x80 <= bytes[2] && bytes[2] <= 0xBF) &&
+                (0x80 <= bytes[3] && bytes[3] <= 0xBF)) ||
+               ((0xF1 <= bytes[0] && bytes[0] <= 0xF3) &&              // planes 4-15
+                (0x80 <= bytes[1] && bytes[1] <= 0xBF) &&
+                (0x80 <= bytes[2] && bytes[2] <= 0xBF) &&
+                (0x80 <= bytes[3] && bytes[3] <= 0xBF)) ||
+               (bytes[0] == 0xF4                         &&            // plane 16
+                (0x80 <= bytes[1] && bytes[1] <= 0x8F) &&
+                (0x80 <= bytes[2] && bytes[2] <= 0xBF) &&
+                (0x80 <= bytes[3] && bytes[3] <= 0xBF))
+              ) {
+        return 4;
+    } else {
+        return 0;
+    }
+}
+
+
 // This function goes through the entire byte array
 // and tries to see whether this is a valid UTF-8 sequence.
 // If it's valid, this is probably a UTF-8 string.
@@ -153,60 +238,36 @@ bool HTMLEncodingResolver::IsValidUtf8(const QByteArray &string)
         return false;
     }
 
-    int index = 0;
+    const unsigned char *bytes = (const unsigned char *) string.constData();
+    const unsigned char *const end = bytes + string.size();
 
-    while (index < string.size()) {
-        QByteArray dword = string.mid(index, 4);
+    while (bytes < end) {
+        // Nearly all markup is plain ASCII, so we skip over it a
+        // block at a time and only look at single characters when
+        // a block has something else in it.
+        while (end - bytes >= ASCII_BLOCK_SIZE && IsAsciiBlock(bytes)) {
+            bytes += ASCII_BLOCK_SIZE;
+        }
 
-        if (dword.size() < 4) {
-            dword = dword.leftJustified(4, '\0');
+        if (bytes == end) {
+            break;
         }
 
-        const unsigned char *bytes = (const unsigned char *) dword.constData();
+        // Bytes past the end read as 0, which is never a valid
+        // continuation byte, just as the padding used to be.
+        unsigned char dword[ 4 ] = { 0, 0, 0, 0 };
 
-        // ASCII
-        if (bytes[0] == 0x09 ||
-            bytes[0] == 0x0A ||
-            bytes[0] == 0x0D ||
-            (0x20 <= bytes[0] && bytes[0] <= 0x7E)
-           ) {
-            index += 1;
+        for (int i = 0; i < 4 && bytes + i < end; ++i) {
+            dword[ i ] = bytes[ i ];
         }
-        // non-overlong 2-byte
-        else if ((0xC2 <= bytes[0] && bytes[0] <= 0xDF) &&
-                 (0x80 <= bytes[1] && bytes[1] <= 0xBF)
-                ) {
-            index += 2;
-        } else if ((bytes[0] == 0xE0                         &&              // excluding overlongs
-                    (0xA0 <= bytes[1] && bytes[1] <= 0xBF) &&
-                    (0x80 <= bytes[2] && bytes[2] <= 0xBF)) ||
-                   (((0xE1 <= bytes[0] && bytes[0] <= 0xEC) ||               // straight 3-byte
-                     bytes[0] == 0xEE                         ||
-                     bytes[0] == 0xEF) &&
-                    (0x80 <= bytes[1] && bytes[1] <= 0xBF)   &&
-                    (0x80 <= bytes[2] && bytes[2] <= 0xBF)) ||
-                   (bytes[0] == 0xED                         &&              // excluding surrogates
-                    (0x80 <= bytes[1] && bytes[1] <= 0x9F) &&
-                    (0x80 <= bytes[2] && bytes[2] <= 0xBF))
-                  ) {
-            index += 3;
-        } else if ((bytes[0] == 0xF0                         &&              // planes 1-3
-                    (0x90 <= bytes[1] && bytes[1] <= 0xBF) &&
-                    (0x80 <= bytes[2] && bytes[2] <= 0xBF) &&
-                    (0x80 <= bytes[3] && bytes[3] <= 0xBF)) ||
-                   ((0xF1 <= bytes[0] && bytes[0] <= 0xF3) &&              // planes 4-15
-                    (0x80 <= bytes[1] && bytes[1] <= 0xBF) &&
-                    (0x80 <= bytes[2] && bytes[2] <= 0xBF) &&
-                    (0x80 <= bytes[3] && bytes[3] <= 0xBF)) ||
-                   (bytes[0] == 0xF4                         &&            // plane 16
-                    (0x80 <= bytes[1] && bytes[1] <= 0x8F) &&
-                    (0x80 <= bytes[2] && bytes[2] <= 0xBF) &&
-                    (0x80 <= bytes[3] && bytes[3] <= 0xBF))
-                  ) {
-            index += 4;
-        } else {
+
+        int length = Utf8SequenceLength(dword);
+
+        if (length == 0) {
             return false;
         }
+
+        bytes += length;
     }
 
     return true;
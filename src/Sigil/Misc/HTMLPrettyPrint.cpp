@@ -20,8 +20,6 @@
 *************************************************************************/
 
 #include <QChar>
-#include <QRegularExpression>
-#include <QRegularExpressionMatch>
 #include <QString>
 #include <QStringList>
 
@@ -63,6 +61,24 @@ static QStringList defaultInlineTags = QStringList()
                                        << "var"
                                        << "video";
 
+// Same as the regex \s, which only matches ASCII whitespace.
+static bool isRegexSpace(const QChar &c)
+{
+    ushort u = c.unicode();
+    return u == ' ' || (u >= '\t' && u <= '\r');
+}
+
+static bool isBlank(const QString &segment)
+{
+    for (int i = 0; i < segment.size(); ++i) {
+        if (!segment.at(i).isSpace()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 HTMLPrettyPrint::HTMLPrettyPrint(const QString &source)
     : m_source(source),
       m_level(-1),
@@ -74,62 +90,62 @@ HTMLPrettyPrint::HTMLPrettyPrint(const QString &source)
     tokenize();
 }
 
-HTMLPrettyPrint::~HTMLPrettyPrint()
-{
-    Q_FOREACH(HTMLToken * t, m_tokens) {
-        delete t;
-        t = 0;
-    }
-}
-
 QString HTMLPrettyPrint::prettyPrint()
 {
     int level = m_level;
     bool in_pre = false;
-    QString indentChar = m_indentChar;
-    QStringList builder;
+    // Indentation is usually outweighed by the whitespace we remove
+    QString builder;
+    builder.reserve(m_source.size() + m_tokens.size());
     QString segment;
-    HTMLToken *last_token = 0;
-    Q_FOREACH(HTMLToken * token, m_tokens) {
-        if (!token) {
-            continue;
-        }
-
-        segment = m_source.mid(token->start, token->len);
-
-        if (token->tag == "pre") {
+    const HTMLToken *last_token = 0;
+    bool last_inline = false;
+    for (int i = 0; i < m_tokens.size(); ++i) {
+        const HTMLToken &token = m_tokens.at(i);
+        QStringRef token_tag = tag(token);
+        QStringRef source = m_source.midRef(token.start, token.len);
+
+        if (token_tag.compare(QLatin1String("pre"), Qt::CaseInsensitive) == 0) {
             in_pre = !in_pre;
         }
 
         if (!in_pre) {
-            segment = cleanSegement(segment);
+            cleanSegement(source, segment);
+        } else {
+            segment.resize(0);
+            segment.append(source);
         }
 
-        if (segment.trimmed().isEmpty()) {
+        if (isBlank(segment)) {
             continue;
         }
 
-        if (m_ignoreInline || ((last_token && last_token->type == TOKEN_TYPE_COMMENT) || token->type == TOKEN_TYPE_COMMENT) || (last_token && last_token->type != TOKEN_TYPE_TEXT && !m_inlineTags.contains(last_token->tag) && !m_inlineTags.contains(token->tag) && token->type != TOKEN_TYPE_TEXT) || (token->type == TOKEN_TYPE_OPEN_TAG && !m_inlineTags.contains(token->tag))) {
-            if (last_token && (last_token->type == TOKEN_TYPE_OPEN_TAG || (!m_ignoreInline && m_inlineTags.contains(last_token->tag))) && (token->type == TOKEN_TYPE_OPEN_TAG || token->type == TOKEN_TYPE_SELF_CLOSING_TAG || token->type == TOKEN_TYPE_COMMENT)) {
+        bool token_inline = isInlineTag(token_tag);
+
+        if (m_ignoreInline || ((last_token && last_token->type == TOKEN_TYPE_COMMENT) || token.type == TOKEN_TYPE_COMMENT) || (last_token && last_token->type != TOKEN_TYPE_TEXT && !last_inline && !token_inline && token.type != TOKEN_TYPE_TEXT) || (token.type == TOKEN_TYPE_OPEN_TAG && !token_inline)) {
+            if (last_token && (last_token->type == TOKEN_TYPE_OPEN_TAG || (!m_ignoreInline && last_inline)) && (token.type == TOKEN_TYPE_OPEN_TAG || token.type == TOKEN_TYPE_SELF_CLOSING_TAG || token.type == TOKEN_TYPE_COMMENT)) {
                 level++;
-            } else if (last_token && (last_token->type == TOKEN_TYPE_CLOSE_TAG || last_token->type == TOKEN_TYPE_SELF_CLOSING_TAG) && token->type != TOKEN_TYPE_OPEN_TAG && token->type != TOKEN_TYPE_SELF_CLOSING_TAG && token->type != TOKEN_TYPE_COMMENT) {
+            } else if (last_token && (last_token->type == TOKEN_TYPE_CLOSE_TAG || last_token->type == TOKEN_TYPE_SELF_CLOSING_TAG) && token.type != TOKEN_TYPE_OPEN_TAG && token.type != TOKEN_TYPE_SELF_CLOSING_TAG && token.type != TOKEN_TYPE_COMMENT) {
                 level--;
             }
 
             if (level > 0 && !in_pre) {
-                builder.append(indentChar.repeated(m_indentCharCount * level));
+                builder.append(QString(m_indentCharCount * level, m_indentChar));
             }
         } else {
-            if (!builder.isEmpty() && builder.last() == "\n") {
-                builder.removeLast();
+            // Every segment is followed by a newline, so the builder
+            // always ends with one here. Inline content joins the line.
+            if (!builder.isEmpty()) {
+                builder.chop(1);
             }
         }
 
         builder.append(segment);
-        builder.append("\n");
-        last_token = token;
+        builder.append(QChar('\n'));
+        last_token = &token;
+        last_inline = token_inline;
     }
-    return builder.join("");
+    return builder;
 }
 
 QStringList HTMLPrettyPrint::inlineTags()
@@ -173,8 +189,11 @@ void HTMLPrettyPrint::tokenize()
     int start = 0;
     bool in_comment = false;
     bool collect_tag = false;
-    size_t tag_start = 0;
-    size_t tag_len = 0;
+    int tag_start = 0;
+    int tag_len = 0;
+
+    // Roughly one tag and one piece of text per 40 characters of markup
+    m_tokens.reserve(m_source.size() / 20);
 
     for (int i = 0; i < m_source.size(); ++i) {
         c = m_source.at(i);
@@ -197,13 +216,15 @@ void HTMLPrettyPrint::tokenize()
                 continue;
             }
 
-            HTMLToken *token = new HTMLToken();
-            token->start = start;
-            token->len = i - start;
+            HTMLToken token;
+            token.start = start;
+            token.len = i - start;
+            token.tag_start = 0;
+            token.tag_len = 0;
             start = i;
 
             if (c == '<') {
-                token->type = TOKEN_TYPE_TEXT;
+                token.type = TOKEN_TYPE_TEXT;
 
                 if (!in_comment) {
                     collect_tag = true;
@@ -212,10 +233,9 @@ void HTMLPrettyPrint::tokenize()
                 }
             } else if (c == '>') {
                 in_comment = false;
-                token->len++;
-                QString segment = m_source.mid(token->start, token->len);
-                token->type = tokenType(segment);
-                token->tag = tag(segment);
+                token.len++;
+                token.type = tokenType(m_source.midRef(token.start, token.len));
+                findTag(token);
                 i++;
                 start++;
             }
@@ -226,23 +246,57 @@ void HTMLPrettyPrint::tokenize()
 
     // Trailing text.
     if (start != m_source.size()) {
-        HTMLToken *token = new HTMLToken();
-        token->start = start;
-        token->len = m_source.size() - start;
-        token->type = TOKEN_TYPE_TEXT;
+        HTMLToken token;
+        token.start = start;
+        token.len = m_source.size() - start;
+        token.tag_start = 0;
+        token.tag_len = 0;
+        token.type = TOKEN_TYPE_TEXT;
         m_tokens.append(token);
     }
 }
 
-QString HTMLPrettyPrint::cleanSegement(const QString &source)
+// Turns line breaks into spaces and then collapses every run
+// of two or more whitespace characters into a single space.
+void HTMLPrettyPrint::cleanSegement(const QStringRef &source, QString &segment)
 {
-    QString segment = source;
-    segment = segment.replace(QRegularExpression("(\\r\\n)|\\n|\\r"), " ");
-    segment = segment.replace(QRegularExpression("\\s{2,}"), " ");
-    return segment;
+    segment.resize(0);
+    const QChar *c = source.unicode();
+    const QChar *end = c + source.size();
+
+    while (c < end) {
+        if (!isRegexSpace(*c)) {
+            segment.append(*c++);
+            continue;
+        }
+
+        QChar first;
+        int run = 0;
+
+        while (c < end && isRegexSpace(*c)) {
+            QChar mapped = *c;
+
+            if (*c == '\r' && c + 1 < end && c[ 1 ] == '\n') {
+                // A Windows line break counts as one character
+                mapped = ' ';
+                c++;
+            } else if (*c == '\r' || *c == '\n') {
+                mapped = ' ';
+            }
+
+            if (run == 0) {
+                first = mapped;
+            }
+
+            run++;
+            c++;
+        }
+
+        segment.append(run > 1 ? QChar(' ') : first);
+    }
 }
 
-HTMLPrettyPrint::TOKEN_TYPE HTMLPrettyPrint::tokenType(const QString &source)
+HTMLPrettyPrint::TOKEN_TYPE HTMLPrettyPrint::tokenType(const QStringRef &source)
 {
     if (source.startsWith("</")) {
         return TOKEN_TYPE_CLOSE_TAG;
@@ -259,16 +313,57 @@ HTMLPrettyPrint::TOKEN_TYPE HTMLPrettyPrint::tokenType(const QString &source)
     return TOKEN_TYPE_OPEN_TAG;
 }
 
-QString HTMLPrettyPrint::tag(const QString &source)
+// Finds the first match of </?\s*([^\s/>]+) in the token.
+void HTMLPrettyPrint::findTag(HTMLToken &token)
 {
-    QString tag;
-    QRegularExpression tag_cap("</?\\s*([^\\s/>]+)");
-    QRegularExpressionMatch mo = tag_cap.match(source);
+    int end = token.start + token.len;
+
+    for (int i = token.start; i < end; ++i) {
+        if (m_source.at(i) != '<') {
+            continue;
+        }
+
+        int name_start = i + 1;
+
+        if (name_start < end && m_source.at(name_start) == '/') {
+            name_start++;
+        }
 
-    if (mo.hasMatch()) {
-        tag = mo.captured(1);
+        while (name_start < end && isRegexSpace(m_source.at(name_start))) {
+            name_start++;
+        }
+
+        int name_end = name_start;
+
+        while (name_end < end &&
+               !isRegexSpace(m_source.at(name_end)) &&
+               m_source.at(name_end) != '/' &&
+               m_source.at(name_end) != '>') {
+            name_end++;
+        }
+
+        if (name_end > name_start) {
+            token.tag_start = name_start;
+            token.tag_len = name_end - name_start;
+            return;
+        }
     }
+}
 
-    return tag.toLower();
+QStringRef HTMLPrettyPrint::tag(const HTMLToken &token) const
+{
+    return m_source.midRef(token.tag_start, token.tag_len);
 }
 
+// Tags are compared without regard to case, so we never have to
+// make a lower case copy of the tag names in the source.
+bool HTMLPrettyPrint::isInlineTag(const QStringRef &tag) const
+{
+    Q_FOREACH(const QString &inline_tag, m_inlineTags) {
+        if (tag.compare(inline_tag, Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -22,17 +22,16 @@
 #ifndef HTML_PRETTY_PRINT
 #define HTML_PRETTY_PRINT
 
-#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
 
 class QChar;
-class QString;
-class QStringList;
 
 class HTMLPrettyPrint
 {
 public:
     HTMLPrettyPrint(const QString &source);
-    ~HTMLPrettyPrint();
 
     QString prettyPrint();
 
@@ -58,20 +57,25 @@ private:
         TOKEN_TYPE_TEXT
     } TOKEN_TYPE;
 
+    // Tokens only refer to their text in m_source,
+    // so tokenizing a file does not copy any of it.
     typedef struct {
         TOKEN_TYPE type;
-        size_t start;
-        size_t len;
-        QString tag;
+        int start;
+        int len;
+        int tag_start;
+        int tag_len;
     } HTMLToken;
 
     void tokenize();
-    QString cleanSegement(const QString &source);
-    TOKEN_TYPE tokenType(const QString &source);
-    QString tag(const QString &source);
+    void cleanSegement(const QStringRef &source, QString &segment);
+    TOKEN_TYPE tokenType(const QStringRef &source);
+    void findTag(HTMLToken &token);
+    QStringRef tag(const HTMLToken &token) const;
+    bool isInlineTag(const QStringRef &tag) const;
 
     QString m_source;
-    QList<HTMLToken *> m_tokens;
+    QVector<HTMLToken> m_tokens;
     int m_level;
     QChar m_indentChar;
     unsigned int m_indentCharCount;
@@ -31,6 +31,10 @@
 #include "sigil_exception.h"
 
 const int MAX_WORD_LENGTH  = 90;
+// The number of characters before the end offset that
+// GetLastMisspelledWord checks first. It doubles until
+// a misspelled word is found.
+static const int LAST_MISSPELLED_WORD_WINDOW = 4096;
 
 QList< HTMLSpellCheck::MisspelledWord > HTMLSpellCheck::GetMisspelledWords(const QString &orig_text,
         int start_offset,
@@ -39,13 +43,12 @@ QList< HTMLSpellCheck::MisspelledWord > HTMLSpellCheck::GetMisspelledWords(const
         bool first_only,
         bool include_all_words)
 {
-    SpellCheck *sc = SpellCheck::instance();
-    bool in_tag = false;
-    bool in_invalid_word = false;
-    bool in_entity = false;
-    int word_start = 0;
-    QRegularExpression search(search_regex);
-    QList< HTMLSpellCheck::MisspelledWord > misspellings;
+    return FindMisspelledWords(PrepareText(orig_text), 0, start_offset, end_offset,
+                               search_regex, first_only, include_all_words);
+}
+
+QString HTMLSpellCheck::PrepareText(const QString &orig_text)
+{
     // Make sure text has beginning/end boundary markers for easier parsing
     QString text = QChar(' ') + orig_text + QChar(' ');
     // Ignore <style...</style> wherever it appears - change to spaces to keep text positions
@@ -59,7 +62,31 @@ QList< HTMLSpellCheck::MisspelledWord > HTMLSpellCheck::GetMisspelledWords(const
         }
     }
 
-    for (int i = 0; i < text.count(); i++) {
+    return text;
+}
+
+QList< HTMLSpellCheck::MisspelledWord > HTMLSpellCheck::FindMisspelledWords(const QString &text,
+        int scan_start,
+        int start_offset,
+        int end_offset,
+        const QString &search_regex,
+        bool first_only,
+        bool include_all_words)
+{
+    SpellCheck *sc = SpellCheck::instance();
+    bool in_tag = false;
+    bool in_invalid_word = false;
+    bool in_entity = false;
+    int word_start = scan_start;
+    QRegularExpression search(search_regex);
+    QList< HTMLSpellCheck::MisspelledWord > misspellings;
+
+    for (int i = scan_start; i < text.count(); i++) {
+        // No word that starts from here on can be in range
+        if (i > end_offset && (word_start == -1 || word_start > end_offset)) {
+            break;
+        }
+
         QChar c = text.at(i);
 
         if (!in_tag) {
@@ -187,11 +214,30 @@ HTMLSpellCheck::MisspelledWord HTMLSpellCheck::GetLastMisspelledWord(const QStri
         int end_offset,
         const QString &search_regex)
 {
-    QList< HTMLSpellCheck::MisspelledWord > misspelled_words = GetMisspelledWords(text, start_offset, end_offset, search_regex);
     HTMLSpellCheck::MisspelledWord misspelled_word;
+    const QString prepared_text = PrepareText(text);
+    // Only spell check the words just before the end offset, and move
+    // further back while none of them are misspelled. The ranges are
+    // next to each other, so together they cover the full range.
+    int window = LAST_MISSPELLED_WORD_WINDOW;
+    int window_end = end_offset;
+
+    while (window_end > start_offset) {
+        int window_start = qMax(start_offset, window_end - window);
+        // Nothing is open right after a '>', so the scan can start from the
+        // last one before the window rather than from the start of the text.
+        // The prepared text is one character ahead of the offsets.
+        int scan_start = prepared_text.lastIndexOf(QChar('>'), window_start) + 1;
+        QList< HTMLSpellCheck::MisspelledWord > misspelled_words =
+            FindMisspelledWords(prepared_text, scan_start, window_start, window_end, search_regex, false, false);
+
+        if (!misspelled_words.isEmpty()) {
+            misspelled_word = misspelled_words.last();
+            break;
+        }
 
-    if (!misspelled_words.isEmpty()) {
-        misspelled_word = misspelled_words.last();
+        window_end = window_start;
+        window *= 2;
     }
 
     return misspelled_word;
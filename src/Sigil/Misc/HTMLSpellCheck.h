@@ -76,6 +76,25 @@ private:
 
     static bool IsBoundary(QChar prev_c, QChar c, QChar next_c);
 
+    /**
+     * Pads the text with boundaries and blanks out <style> blocks,
+     * keeping every other character at its position plus one.
+     */
+    static QString PrepareText(const QString &orig_text);
+
+    /**
+     * Finds the words of a prepared text that start between the offsets,
+     * scanning from scan_start. Scanning has to start at the beginning of
+     * the text or right after a '>', where no tag, entity or word is open.
+     */
+    static QList< MisspelledWord > FindMisspelledWords(const QString &text,
+            int scan_start,
+            int start_offset,
+            int end_offset,
+            const QString &search_regex,
+            bool first_only,
+            bool include_all_words);
+
 };
 
 #endif // HTMLSPELLCHECK_H
@@ -19,16 +19,20 @@
 **
 *************************************************************************/
 
-#include <QtCore>
+#include <QtCore/QCache>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
+#include <QtConcurrent/QtConcurrent>
+#include <QtGui/QImageReader>
 #include <QtGui/QPainter>
-#include <QtGui/QPixmap>
+#include <QtSvg/QSvgRenderer>
 #include <QtWebKitWidgets/QWebPage>
 #include <QtWebKitWidgets/QWebFrame>
 
 #include "Misc/RasterizeImageResource.h"
-#include "Misc/SleepFunctions.h"
 #include "Misc/Utility.h"
-#include "ResourceObjects/ImageResource.h"
+#include "ResourceObjects/Resource.h"
 
 static const QString PAGE_SOURCE =  "<html xmlns=\"http://www.w3.org/1999/xhtml\" xml:lang=\"en\">"
                                     "<head>"
@@ -39,48 +43,195 @@ static const QString PAGE_SOURCE =  "<html xmlns=\"http://www.w3.org/1999/xhtml\
                                     "</body>"
                                     "</html>";
 
+// SVG elements outside of SVG Tiny that QSvgRenderer ignores.
+static const QStringList WEBKIT_ONLY_SVG_ELEMENTS = QStringList() << "<filter" << "<mask" << "<clipPath"
+                                                                  << "<pattern" << "<foreignObject" << "<style";
+
+// The cache cost is in KB, so this keeps up to 64 MB of images.
+static const int MAX_CACHE_COST = 64 * 1024;
+
+static QMutex cache_mutex;
+static QCache< QString, QImage > image_cache(MAX_CACHE_COST);
+
 
 RasterizeImageResource::RasterizeImageResource(QWidget *parent)
     :
     QObject(parent),
-    m_WebPage(*new QWebPage(this)),
-    m_LoadFinishedFlag(false)
+    m_WebPageBusy(false),
+    m_WebPage(NULL)
+{
+}
+
+
+QImage RasterizeImageResource::RasterizeFile(const QString &path, float zoom_factor)
+{
+    const QString key = CacheKey(path, zoom_factor);
+    {
+        QMutexLocker locker(&cache_mutex);
+
+        if (image_cache.contains(key)) {
+            return *image_cache.object(key);
+        }
+    }
+    QImage image;
+
+    if (QFileInfo(path).suffix().toLower() == "svg") {
+        if (SVGNeedsWebKit(path)) {
+            return QImage();
+        }
+
+        image = RenderSVG(path, zoom_factor);
+    } else {
+        QImageReader reader(path);
+        const QSize size = reader.size();
+
+        // Let the decoder do the scaling, it is much cheaper for JPGs
+        if (size.isValid() && zoom_factor != 1.0) {
+            reader.setScaledSize(size * zoom_factor);
+        }
+
+        image = reader.read();
+    }
+
+    if (!image.isNull()) {
+        CacheImage(path, zoom_factor, image);
+    }
+
+    return image;
+}
+
+
+QImage RasterizeImageResource::RasterizeFileToFit(const QString &path, int max_size)
+{
+    const QSize size = QImageReader(path).size();
+
+    if (!size.isValid() || size.isEmpty()) {
+        return QImage();
+    }
+
+    float zoom_factor = qMin(1.0, static_cast<double>(max_size) / qMax(size.width(), size.height()));
+    return RasterizeFile(path, zoom_factor);
+}
+
+
+void RasterizeImageResource::Rasterize(const Resource &resource, float zoom_factor)
+{
+    Request request;
+    request.path = resource.GetFullPath();
+    request.filename = resource.Filename();
+    request.base_url = resource.GetBaseUrl();
+    request.zoom_factor = zoom_factor;
+    QFutureWatcher< QImage > *watcher = new QFutureWatcher< QImage >(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(RasterizeFinished()));
+    m_Running[ watcher ] = request;
+    watcher->setFuture(QtConcurrent::run(RasterizeFile, request.path, zoom_factor));
+}
+
+
+void RasterizeImageResource::RasterizeFinished()
 {
-    connect(m_WebPage.mainFrame(), SIGNAL(loadFinished(bool)), this, SLOT(SetLoadFinishedFlag()));
+    QFutureWatcher< QImage > *watcher = static_cast< QFutureWatcher< QImage > * >(sender());
+    const Request request = m_Running.take(watcher);
+    const QImage image = watcher->result();
+    watcher->deleteLater();
+
+    if (image.isNull() && QFileInfo(request.path).suffix().toLower() == "svg") {
+        m_WebPageQueue.append(request);
+        LoadNextInWebPage();
+        return;
+    }
+
+    emit Rasterized(request.path, request.zoom_factor, image);
 }
 
 
-// We could use the native QPixmap loading process for JPG, PNG and GIF images.
-// But we have to use webkit to rasterize SVG's since QSvgRenderer supports
-// only SVG Tiny. And if we're going to use webkit, then let's use it for all
-// image types to reduce complexity. It also makes zooming/scaling much simpler.
-QPixmap RasterizeImageResource::operator()(const ImageResource &resource, float zoom_factor)
+void RasterizeImageResource::LoadNextInWebPage()
 {
+    if (m_WebPageBusy || m_WebPageQueue.isEmpty()) {
+        return;
+    }
+
+    if (!m_WebPage) {
+        m_WebPage = new QWebPage(this);
+        connect(m_WebPage->mainFrame(), SIGNAL(loadFinished(bool)), this, SLOT(WebPageLoadFinished()));
+    }
+
+    m_WebPageBusy = true;
+    const Request &request = m_WebPageQueue.first();
     QString source(PAGE_SOURCE);
-    source.replace("REPLACEME", Utility::URLEncodePath(resource.Filename()));
-    m_WebPage.mainFrame()->setHtml(source, resource.GetBaseUrl());
-    m_WebPage.mainFrame()->setZoomFactor(zoom_factor);
-
-    while (!m_LoadFinishedFlag) {
-        // Make sure Qt processes events, signals and calls slots
-        qApp->processEvents();
-        SleepFunctions::msleep(10);
+    source.replace("REPLACEME", Utility::URLEncodePath(request.filename));
+    m_WebPage->mainFrame()->setHtml(source, request.base_url);
+    m_WebPage->mainFrame()->setZoomFactor(request.zoom_factor);
+}
+
+
+void RasterizeImageResource::WebPageLoadFinished()
+{
+    if (!m_WebPageBusy) {
+        return;
     }
 
-    // The flag needs to be reset so the caller
-    // can call this func multiple times on the same object
-    m_LoadFinishedFlag = false;
+    const Request request = m_WebPageQueue.takeFirst();
     // Now we render the frame onto an image
-    m_WebPage.setViewportSize(m_WebPage.mainFrame()->contentsSize());
-    QImage image(m_WebPage.viewportSize(), QImage::Format_ARGB32);
+    m_WebPage->setViewportSize(m_WebPage->mainFrame()->contentsSize());
+    QImage image(m_WebPage->viewportSize(), QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    m_WebPage->mainFrame()->render(&painter);
+    painter.end();
+    CacheImage(request.path, request.zoom_factor, image);
+    m_WebPageBusy = false;
+    emit Rasterized(request.path, request.zoom_factor, image);
+    LoadNextInWebPage();
+}
+
+
+bool RasterizeImageResource::SVGNeedsWebKit(const QString &path)
+{
+    QString source;
+
+    try {
+        source = Utility::ReadUnicodeTextFile(path);
+    } catch (...) {
+        return true;
+    }
+
+    foreach(QString element, WEBKIT_ONLY_SVG_ELEMENTS) {
+        if (source.contains(element)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+QImage RasterizeImageResource::RenderSVG(const QString &path, float zoom_factor)
+{
+    QSvgRenderer renderer(path);
+
+    if (!renderer.isValid() || renderer.defaultSize().isEmpty()) {
+        return QImage();
+    }
+
+    QImage image(renderer.defaultSize() * zoom_factor, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
     QPainter painter(&image);
-    m_WebPage.mainFrame()->render(&painter);
+    renderer.render(&painter);
     painter.end();
-    return QPixmap::fromImage(image);
+    return image;
+}
+
+
+QString RasterizeImageResource::CacheKey(const QString &path, float zoom_factor)
+{
+    return QString("%1|%2|%3").arg(path)
+           .arg(QFileInfo(path).lastModified().toMSecsSinceEpoch())
+           .arg(zoom_factor);
 }
 
 
-void RasterizeImageResource::SetLoadFinishedFlag()
+void RasterizeImageResource::CacheImage(const QString &path, float zoom_factor, const QImage &image)
 {
-    m_LoadFinishedFlag = true;
+    QMutexLocker locker(&cache_mutex);
+    image_cache.insert(CacheKey(path, zoom_factor), new QImage(image), qMax(1, image.byteCount() / 1024));
 }
@@ -23,13 +23,25 @@
 #ifndef RASTERIZEIMAGERESOURCE_H
 #define RASTERIZEIMAGERESOURCE_H
 
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QObject>
+#include <QtCore/QUrl>
+#include <QtGui/QImage>
 
 class QWebPage;
-class QPixmap;
-class ImageResource;
+class Resource;
+template <typename T> class QFutureWatcher;
 
 
+/**
+ * Rasterizes image files (bitmaps and SVGs) at a given zoom factor.
+ *
+ * Bitmaps are decoded with QImageReader and SVGs are rendered with
+ * QSvgRenderer, so the work can run on worker threads. Only SVGs that
+ * use features QSvgRenderer does not support (it only handles SVG Tiny)
+ * are handed to webkit, on the GUI thread.
+ */
 class RasterizeImageResource : public QObject
 {
     Q_OBJECT
@@ -38,18 +50,90 @@ public:
 
     RasterizeImageResource(QWidget *parent = 0);
 
-    QPixmap operator()(const ImageResource &resource, float zoom_factor);
+    /**
+     * Rasterizes the image at the given zoom factor. Thread safe.
+     * The results are cached by path, modification time and zoom factor.
+     *
+     * @return The image, or a null image if the file could not be
+     *         rasterized without webkit.
+     */
+    static QImage RasterizeFile(const QString &path, float zoom_factor);
+
+    /**
+     * Rasterizes the image so that it fits in a square of max_size
+     * pixels. Images that are already small enough are not scaled up.
+     * Thread safe.
+     */
+    static QImage RasterizeFileToFit(const QString &path, int max_size);
+
+    /**
+     * Starts rasterizing the resource on a worker thread.
+     * Rasterized() is emitted once the image is ready.
+     */
+    void Rasterize(const Resource &resource, float zoom_factor);
+
+signals:
+
+    /**
+     * Emitted when a Rasterize() request completes.
+     * The image is null if the file could not be rasterized.
+     */
+    void Rasterized(const QString &path, float zoom_factor, const QImage &image);
 
 private slots:
 
-    void SetLoadFinishedFlag();
+    void RasterizeFinished();
+
+    void WebPageLoadFinished();
 
 private:
 
-    QWebPage &m_WebPage;
+    struct Request {
+        QString path;
+        QString filename;
+        QUrl base_url;
+        float zoom_factor;
+    };
+
+    /**
+     * Returns whether the SVG uses features that QSvgRenderer
+     * does not support and would silently drop.
+     */
+    static bool SVGNeedsWebKit(const QString &path);
+
+    static QImage RenderSVG(const QString &path, float zoom_factor);
+
+    static QString CacheKey(const QString &path, float zoom_factor);
+
+    static void CacheImage(const QString &path, float zoom_factor, const QImage &image);
+
+    /**
+     * Loads the next SVG waiting for webkit, if webkit is idle.
+     */
+    void LoadNextInWebPage();
+
+
+    ///////////////////////////////
+    // PRIVATE MEMBER VARIABLES
+    ///////////////////////////////
+
+    /**
+     * The requests currently running on worker threads.
+     */
+    QHash< QFutureWatcher< QImage > *, Request > m_Running;
+
+    /**
+     * The SVGs waiting to be rendered by webkit,
+     * the first one is loading if m_WebPageBusy.
+     */
+    QList< Request > m_WebPageQueue;
 
-    bool m_LoadFinishedFlag;
+    bool m_WebPageBusy;
 
+    /**
+     * Only created for the first SVG that needs it.
+     */
+    QWebPage *m_WebPage;
 };
 
 #endif // RASTERIZEIMAGERESOURCE_H
@@ -53,7 +53,9 @@ SpellCheck *SpellCheck::instance()
 
 SpellCheck::SpellCheck() :
     m_hunspell(0),
-    m_codec(0)
+    m_codec(0),
+    m_generation(0),
+    m_lock(QMutex::Recursive)
 {
     // There is a considerable lag involved in loading the Spellcheck dictionaries
     QApplication::setOverrideCursor(Qt::WaitCursor);
@@ -119,6 +121,8 @@ QString SpellCheck::currentDictionary() const
 
 bool SpellCheck::spell(const QString &word)
 {
+    QMutexLocker locker(&m_lock);
+
     if (!m_hunspell) {
         return true;
     }
@@ -128,6 +132,8 @@ bool SpellCheck::spell(const QString &word)
 
 QStringList SpellCheck::suggest(const QString &word)
 {
+    QMutexLocker locker(&m_lock);
+
     if (!m_hunspell) {
         return QStringList();
     }
@@ -146,12 +152,14 @@ QStringList SpellCheck::suggest(const QString &word)
 
 void SpellCheck::clearIgnoredWords()
 {
+    QMutexLocker locker(&m_lock);
     m_ignoredWords.clear();
     reloadDictionary();
 }
 
 void SpellCheck::ignoreWord(const QString &word)
 {
+    QMutexLocker locker(&m_lock);
     ignoreWordInDictionary(word);
 
     m_ignoredWords.append(word);
@@ -159,15 +167,26 @@ void SpellCheck::ignoreWord(const QString &word)
 
 void SpellCheck::ignoreWordInDictionary(const QString &word)
 {
+    QMutexLocker locker(&m_lock);
+
     if (!m_hunspell) {
         return;
     }
     
     m_hunspell->add(m_codec->fromUnicode(Utility::getSpellingSafeText(word)).constData());
+    m_generation++;
+}
+
+int SpellCheck::generation() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_generation;
 }
 
 void SpellCheck::setDictionary(const QString &name, bool forceReplace)
 {
+    QMutexLocker locker(&m_lock);
+
     // See if we are already using a hunspell object for this language.
     if (!forceReplace && m_dictionaryName == name && m_hunspell) {
         return;
@@ -179,6 +198,8 @@ void SpellCheck::setDictionary(const QString &name, bool forceReplace)
         m_hunspell = 0;
     }
 
+    m_generation++;
+
     // Save the dictionary name for use later.
     m_dictionaryName = name;
 
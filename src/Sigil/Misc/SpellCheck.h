@@ -24,6 +24,7 @@
 #define SPELLCHECK_H
 
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 
@@ -33,6 +34,9 @@ class QTextCodec;
 
 /**
  * Singleton.
+ *
+ * Checking and changing words is serialized, so spell()
+ * and suggest() can be called from worker threads.
  */
 class SpellCheck
 {
@@ -49,6 +53,12 @@ public:
     void ignoreWord(const QString &word);
     void ignoreWordInDictionary(const QString &word);
 
+    /**
+     * Changes every time the words accepted by the spellchecker
+     * change, so callers can tell when cached results went stale.
+     */
+    int generation() const;
+
     void setDictionary(const QString &name, bool forceReplace = false);
     void reloadDictionary();
 
@@ -75,6 +85,10 @@ private:
     //
     QHash<QString, QString> m_dictionaries;
     QStringList m_ignoredWords;
+    int m_generation;
+
+    // Recursive, setDictionary() ignores words while holding it.
+    mutable QMutex m_lock;
 
     static SpellCheck *m_instance;
 };
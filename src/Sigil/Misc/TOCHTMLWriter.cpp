@@ -27,7 +27,12 @@
 
 const QString SGC_TOC_CSS_FILENAME = "sgc-toc.css";
 
-TOCHTMLWriter::TOCHTMLWriter(NCXModel::NCXEntry ncx_root_entry)
+// The markup around one entry's text and target, with some room for escaping.
+static const int ENTRY_MARKUP_SIZE = 64;
+// The head and the page heading.
+static const int PAGE_MARKUP_SIZE = 512;
+
+TOCHTMLWriter::TOCHTMLWriter(const NCXModel::NCXEntry &ncx_root_entry)
     :
     m_Writer(0),
     m_NCXRootEntry(ncx_root_entry)
@@ -45,6 +50,7 @@ TOCHTMLWriter::~TOCHTMLWriter()
 QString TOCHTMLWriter::WriteXML()
 {
     QString out;
+    out.reserve(PAGE_MARKUP_SIZE + EstimateEntriesSize(m_NCXRootEntry));
 
     // Use QXmlStreamWriter to ensure correct conversion of &, <, etc.
     if (m_Writer) {
@@ -100,9 +106,9 @@ void TOCHTMLWriter::WriteBody()
     WriteEntries(m_NCXRootEntry);
 }
 
-void TOCHTMLWriter::WriteEntries(NCXModel::NCXEntry parent_entry, int level)
+void TOCHTMLWriter::WriteEntries(const NCXModel::NCXEntry &parent_entry, int level)
 {
-    foreach(NCXModel::NCXEntry entry, parent_entry.children) {
+    foreach(const NCXModel::NCXEntry & entry, parent_entry.children) {
         m_Writer->writeStartElement("div");
         m_Writer->writeAttribute("class", "sgc-toc-level-" % QString::number(level));
         m_Writer->writeCharacters("\n");
@@ -118,3 +124,13 @@ void TOCHTMLWriter::WriteEntries(NCXModel::NCXEntry parent_entry, int level)
         m_Writer->writeCharacters("\n");
     }
 }
+
+int TOCHTMLWriter::EstimateEntriesSize(const NCXModel::NCXEntry &parent_entry)
+{
+    int size = 0;
+    foreach(const NCXModel::NCXEntry & entry, parent_entry.children) {
+        size += ENTRY_MARKUP_SIZE + entry.text.size() + entry.target.size();
+        size += EstimateEntriesSize(entry);
+    }
+    return size;
+}
@@ -33,7 +33,7 @@ class QXmlStreamWriter;
 class TOCHTMLWriter
 {
 public:
-    TOCHTMLWriter(NCXModel::NCXEntry ncx_root_entry);
+    TOCHTMLWriter(const NCXModel::NCXEntry &ncx_root_entry);
     ~TOCHTMLWriter();
 
     QString WriteXML();
@@ -41,7 +41,13 @@ public:
 private:
     void WriteHead();
     void WriteBody();
-    void WriteEntries(NCXModel::NCXEntry entry, int level = 1);
+    void WriteEntries(const NCXModel::NCXEntry &entry, int level = 1);
+
+    /**
+     * Estimates how many characters the entries
+     * will take up in the output, to pre-size it.
+     */
+    static int EstimateEntriesSize(const NCXModel::NCXEntry &parent_entry);
 
     QXmlStreamWriter *m_Writer;
 
@@ -19,6 +19,7 @@
 **
 *************************************************************************/
 
+#include <limits.h>
 #include <stdio.h>
 #include <time.h>
 
@@ -304,6 +305,90 @@ bool Utility::IsFileReadable(const QString &fullfilepath)
 }
 
 
+// Decodes UTF-8 into text while converting Mac and Windows style
+// line endings to Unix style ones, in a single pass and without any
+// intermediate copies. Returns false (leaving text in an undefined
+// state) if the data is not valid UTF-8.
+static bool DecodeUtf8WithUnixLineEndings(const uchar *data, qint64 size, QString &text)
+{
+    // A byte never decodes to more than one UTF-16 code unit,
+    // except four byte sequences that decode to two.
+    text.resize(size);
+    ushort *out = reinterpret_cast< ushort * >(text.data());
+    ushort *const out_start = out;
+    const uchar *const end = data + size;
+
+    while (data < end) {
+        uchar byte = *data++;
+
+        if (byte < 0x80) {
+            if (byte == '\r') {
+                *out++ = '\n';
+
+                if (data < end && *data == '\n') {
+                    ++data;
+                }
+            } else {
+                *out++ = byte;
+            }
+
+            continue;
+        }
+
+        uint code_point;
+        int continuation_bytes;
+        uint minimum;
+
+        if ((byte & 0xE0) == 0xC0) {
+            code_point = byte & 0x1F;
+            continuation_bytes = 1;
+            minimum = 0x80;
+        } else if ((byte & 0xF0) == 0xE0) {
+            code_point = byte & 0x0F;
+            continuation_bytes = 2;
+            minimum = 0x800;
+        } else if ((byte & 0xF8) == 0xF0) {
+            code_point = byte & 0x07;
+            continuation_bytes = 3;
+            minimum = 0x10000;
+        } else {
+            return false;
+        }
+
+        if (end - data < continuation_bytes) {
+            return false;
+        }
+
+        for (int i = 0; i < continuation_bytes; ++i) {
+            byte = *data++;
+
+            if ((byte & 0xC0) != 0x80) {
+                return false;
+            }
+
+            code_point = (code_point << 6) | (byte & 0x3F);
+        }
+
+        // Reject overlong forms, surrogates and values past the Unicode range
+        if (code_point < minimum ||
+            (code_point >= 0xD800 && code_point <= 0xDFFF) ||
+            code_point > 0x10FFFF) {
+            return false;
+        }
+
+        if (code_point >= 0x10000) {
+            *out++ = QChar::highSurrogate(code_point);
+            *out++ = QChar::lowSurrogate(code_point);
+        } else {
+            *out++ = code_point;
+        }
+    }
+
+    text.resize(out - out_start);
+    return true;
+}
+
+
 // Reads the text file specified with the full file path;
 // text needs to be in UTF-8 or UTF-16; if the file cannot
 // be read, an error dialog is shown and an empty string returned
@@ -321,6 +406,40 @@ QString Utility::ReadUnicodeTextFile(const QString &fullfilepath)
                    );
     }
 
+    qint64 size = file.size();
+
+    if (size == 0) {
+        return QString();
+    }
+
+    // Fast path: nearly all our files are UTF-8, so we map the file
+    // and decode it straight into the result. Anything that is not
+    // valid UTF-8 (or has a UTF-16/32 BOM) goes through QTextStream.
+    if (size < INT_MAX) {
+        uchar *data = file.map(0, size);
+
+        if (data) {
+            const uchar *start = data;
+
+            // Skip the UTF-8 BOM, the same as QTextStream does
+            if (size >= 3 && data[ 0 ] == 0xEF && data[ 1 ] == 0xBB && data[ 2 ] == 0xBF) {
+                start += 3;
+            }
+
+            bool utf16_or_32_bom = size >= 2 &&
+                                   ((data[ 0 ] == 0xFF && data[ 1 ] == 0xFE) ||
+                                    (data[ 0 ] == 0xFE && data[ 1 ] == 0xFF) ||
+                                    (data[ 0 ] == 0x00 && data[ 1 ] == 0x00));
+            QString text;
+
+            if (!utf16_or_32_bom && DecodeUtf8WithUnixLineEndings(start, size - (start - data), text)) {
+                return text;
+            }
+
+            file.unmap(data);
+        }
+    }
+
     QTextStream in(&file);
     // Input should be UTF-8
     in.setCodec("UTF-8");
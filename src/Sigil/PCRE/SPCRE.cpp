@@ -25,6 +25,65 @@
 
 // The maximum number of catpures that we will allow.
 const int PCRE_MAX_CAPTURE_GROUPS = 30;
+// The number of characters before the end that getLastMatchInfo
+// looks at first. It doubles until the result can be trusted.
+static const int LAST_MATCH_WINDOW = 4096;
+
+// Returns the offset, relative to start, of the first line
+// that begins at least window characters before end.
+static int LastMatchWindowStart(const QString &text, int start, int end, int window)
+{
+    if (end - start <= window) {
+        return 0;
+    }
+
+    return qMax(0, text.lastIndexOf(QChar('\n'), end - window - 1) + 1 - start);
+}
+
+// Returns false only if no match of the pattern can contain a line break.
+// Anything that is not known to stay on one line counts as spanning lines:
+// control characters, escapes that match a line break or an arbitrary
+// character (including backreferences and \G), negated and POSIX classes,
+// the dotall option and newline convention verbs.
+static bool PatternCanSpanLines(const QString &pattern)
+{
+    static const QString LINE_SPANNING_ESCAPES = "sSRvHXCDWnrxocpPGgk0123456789";
+    int length = pattern.length();
+
+    for (int i = 0; i < length; i++) {
+        QChar c = pattern.at(i);
+
+        if (c.unicode() < 0x20) {
+            return true;
+        }
+
+        if (c == '\\') {
+            i++;
+
+            if (i < length && LINE_SPANNING_ESCAPES.contains(pattern.at(i))) {
+                return true;
+            }
+        } else if (c == '[') {
+            if (i + 1 < length && (pattern.at(i + 1) == '^' || pattern.at(i + 1) == ':')) {
+                return true;
+            }
+        } else if (c == '(' && i + 1 < length) {
+            if (pattern.at(i + 1) == '*') {
+                return true;
+            }
+
+            if (pattern.at(i + 1) == '?') {
+                for (int j = i + 2; j < length && (pattern.at(j).isLetter() || pattern.at(j) == '-'); j++) {
+                    if (pattern.at(j) == 's') {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
 
 SPCRE::SPCRE(const QString &patten)
 {
@@ -32,6 +91,7 @@ SPCRE::SPCRE(const QString &patten)
     m_re = NULL;
     m_study = NULL;
     m_captureSubpatternCount = 0;
+    m_matchesStayOnOneLine = false;
     const char *error;
     int erroroffset;
     m_re = pcre16_compile(m_pattern.utf16(), PCRE_UTF16 | PCRE_MULTILINE, &error, &erroroffset, NULL);
@@ -43,6 +103,10 @@ SPCRE::SPCRE(const QString &patten)
         m_study = pcre16_study(m_re, 0, &error);
         // Store the number of capture subpatterns.
         pcre16_fullinfo(m_re, m_study, PCRE_INFO_CAPTURECOUNT, &m_captureSubpatternCount);
+        // Empty matches end a scan, so those patterns need a full scan too.
+        int min_length = 0;
+        pcre16_fullinfo(m_re, m_study, PCRE_INFO_MINLENGTH, &min_length);
+        m_matchesStayOnOneLine = min_length > 0 && !PatternCanSpanLines(m_pattern);
     }
     // Pattern is not valid.
     else {
@@ -103,22 +167,81 @@ int SPCRE::getCaptureStringNumber(const QString &name)
     return number;
 }
 
+// Narrows [start, end) the same way text.mid(start, end - start) would.
+// Returns false if that substring is empty.
+static bool ClampRange(const QString &text, int &start, int &end)
+{
+    int length = text.length();
+    int n = end - start;
+
+    if (start > length) {
+        return false;
+    }
+
+    if (start < 0) {
+        if (n < 0 || n + start >= length) {
+            start = 0;
+            end = length;
+            return length > 0;
+        }
+
+        if (n + start <= 0) {
+            return false;
+        }
+
+        n += start;
+        start = 0;
+    } else if (uint(n) > uint(length - start)) {
+        n = length - start;
+    }
+
+    end = start + n;
+    return n > 0;
+}
+
 QList<SPCRE::MatchInfo> SPCRE::getEveryMatchInfo(const QString &text)
 {
-    // This function is very similar to getNextMatchInfo but we don't
-    // want to put a call to getNextMatchInfo in a loop because it allocates
-    // a new ovector. We want to avoid this and only do one allocation so we
-    // reuse the logic and put the call to generateMatchInfo in the loop.
+    return getEveryMatchInfo(text, 0, text.length());
+}
+
+QList<SPCRE::MatchInfo> SPCRE::getEveryMatchInfo(const QString &text, int start, int end)
+{
     QList<SPCRE::MatchInfo> info;
 
-    if (m_re == NULL || text.isEmpty()) {
+    if (m_re == NULL || !ClampRange(text, start, end)) {
         return info;
     }
 
+    findEveryMatch(text.utf16() + start, end - start, 0, &info, NULL);
+    return info;
+}
+
+int SPCRE::countMatches(const QString &text)
+{
+    return countMatches(text, 0, text.length());
+}
+
+int SPCRE::countMatches(const QString &text, int start, int end)
+{
+    if (m_re == NULL || !ClampRange(text, start, end)) {
+        return 0;
+    }
+
+    return findEveryMatch(text.utf16() + start, end - start, 0, NULL, NULL);
+}
+
+int SPCRE::findEveryMatch(const ushort *subject, int length, int offset, QList<SPCRE::MatchInfo> *info, MatchInfo *last_info)
+{
+    // This function is very similar to getNextMatchInfo but we don't
+    // want to put a call to getNextMatchInfo in a loop because it allocates
+    // a new ovector. We want to avoid this and only do one allocation so we
+    // reuse the logic and put the call to generateMatchInfo in the loop.
+    int count = 0;
     int rc = 0;
     // Set the size of the array based on the number of capture subpatterns
-    // if it does not exceed our maximum size.
-    int ovector_count = getCaptureSubpatternCount();
+    // if it does not exceed our maximum size. When we are only counting
+    // the capture subpatterns are of no interest.
+    int ovector_count = info || last_info ? getCaptureSubpatternCount() : 0;
 
     if (ovector_count > PCRE_MAX_CAPTURE_GROUPS) {
         ovector_count = PCRE_MAX_CAPTURE_GROUPS;
@@ -133,6 +256,9 @@ QList<SPCRE::MatchInfo> SPCRE::getEveryMatchInfo(const QString &text)
     // MSVC doesn't support it.
     int *ovector = new int[ovector_size];
     memset(ovector, 0, sizeof(int)*ovector_size);
+    // The first search starts at the offset.
+    ovector[0] = offset;
+    ovector[1] = offset;
     // We keep track of the last offsets as we move though the string matching
     // sub strings.
     int last_offset[2] = {0};
@@ -146,22 +272,35 @@ QList<SPCRE::MatchInfo> SPCRE::getEveryMatchInfo(const QString &text)
 
         // We only care about matches that have text in it.
         if (last_offset[0] != last_offset[1]) {
+            count++;
+
             // Add the matched information to the list.
-            info.append(generateMatchInfo(ovector, ovector_count));
+            if (info) {
+                info->append(generateMatchInfo(ovector, ovector_count));
+            }
+
+            if (last_info) {
+                *last_info = generateMatchInfo(ovector, ovector_count);
+            }
         }
 
-        rc = pcre16_exec(m_re, m_study, text.utf16(), text.length(), last_offset[1], 0, ovector, ovector_size);
+        rc = pcre16_exec(m_re, m_study, subject, length, last_offset[1], 0, ovector, ovector_size);
     } while (rc >= 0 && ovector[0] != ovector[1] && ovector[1] != last_offset[1] && ovector[0] < ovector[1]);
 
     delete[] ovector;
-    return info;
+    return count;
 }
 
 SPCRE::MatchInfo SPCRE::getFirstMatchInfo(const QString &text)
+{
+    return getFirstMatchInfo(text, 0, text.length());
+}
+
+SPCRE::MatchInfo SPCRE::getFirstMatchInfo(const QString &text, int start, int end)
 {
     SPCRE::MatchInfo match_info;
 
-    if (m_re == NULL || text.isEmpty()) {
+    if (m_re == NULL || !ClampRange(text, start, end)) {
         return match_info;
     }
 
@@ -183,7 +322,7 @@ SPCRE::MatchInfo SPCRE::getFirstMatchInfo(const QString &text)
     // MSVC doesn't support it.
     int *ovector = new int[ovector_size];
     memset(ovector, 0, sizeof(int)*ovector_size);
-    rc = pcre16_exec(m_re, m_study, text.utf16(), text.length(), 0, 0, ovector, ovector_size);
+    rc = pcre16_exec(m_re, m_study, text.utf16() + start, end - start, 0, 0, ovector, ovector_size);
 
     if (rc >= 0 && ovector[0] != ovector[1]) {
         match_info = generateMatchInfo(ovector, ovector_count);
@@ -195,14 +334,53 @@ SPCRE::MatchInfo SPCRE::getFirstMatchInfo(const QString &text)
 
 SPCRE::MatchInfo SPCRE::getLastMatchInfo(const QString &text)
 {
-    QList<SPCRE::MatchInfo> info;
-    info = getEveryMatchInfo(text);
+    return getLastMatchInfo(text, 0, text.length());
+}
+
+SPCRE::MatchInfo SPCRE::getLastMatchInfo(const QString &text, int start, int end)
+{
+    SPCRE::MatchInfo match_info;
+
+    if (m_re == NULL || !ClampRange(text, start, end)) {
+        return match_info;
+    }
+
+    int length = end - start;
 
-    if (!info.isEmpty()) {
-        return info.last();
-    } else {
-        return SPCRE::MatchInfo();
+    // A match that can contain a line break can start anywhere before the
+    // end, and a scan that stops at an empty match depends on everything
+    // before it, so only a scan of the whole text gives the right answer.
+    if (!m_matchesStayOnOneLine) {
+        findEveryMatch(text.utf16() + start, length, 0, NULL, &match_info);
+        return match_info;
     }
+
+    // Otherwise searching up from near the end of a large text should not
+    // cost a scan of the whole text. We search windows that end at the end
+    // and start at the beginning of a line, doubling them until one holds
+    // a match. As no match spans a line break, a scan of the whole text
+    // is never inside a match at a line start, so from there on it finds
+    // exactly the matches the window scan finds. The whole text is still
+    // passed to PCRE, so anchors and lookbehinds see the text before the
+    // window.
+    int window = LAST_MATCH_WINDOW;
+    int window_start = LastMatchWindowStart(text, start, end, window);
+    findEveryMatch(text.utf16() + start, length, window_start, NULL, &match_info);
+
+    while (match_info.offset.first == -1 && window_start > 0) {
+        window = window < length / 2 ? window * 2 : length;
+        int earlier_start = LastMatchWindowStart(text, start, end, window);
+
+        // A long line; keep growing until we pass its start
+        if (earlier_start == window_start) {
+            continue;
+        }
+
+        findEveryMatch(text.utf16() + start, length, earlier_start, NULL, &match_info);
+        window_start = earlier_start;
+    }
+
+    return match_info;
 }
 
 bool SPCRE::replaceText(const QString &text, const QList<std::pair<int, int> > &capture_groups_offsets, const QString &replacement_pattern, QString &out)
@@ -126,6 +126,31 @@ public:
     MatchInfo getFirstMatchInfo(const QString &text);
     MatchInfo getLastMatchInfo(const QString &text);
 
+    /**
+     * The same as the functions above run on text.mid(start, end - start),
+     * but without copying the text. The returned offsets are relative
+     * to start, exactly as if the substring had been passed.
+     *
+     * getLastMatchInfo searches backwards from end in growing windows
+     * when no match of the pattern can span a line break, so its cost
+     * depends on the distance to the match rather than on the length of
+     * the text. Other patterns are matched against the whole text.
+     */
+    QList<MatchInfo> getEveryMatchInfo(const QString &text, int start, int end);
+    MatchInfo getFirstMatchInfo(const QString &text, int start, int end);
+    MatchInfo getLastMatchInfo(const QString &text, int start, int end);
+
+    /**
+     * Counts the matches getEveryMatchInfo would return,
+     * without building the list.
+     *
+     * @param text The text to search.
+     *
+     * @return The number of matches.
+     */
+    int countMatches(const QString &text);
+    int countMatches(const QString &text, int start, int end);
+
     /**
      * Replaces the given text using a replacement pattern. The matched text is
      * required because the replacement pattern can references the capture
@@ -145,6 +170,15 @@ public:
 private:
     MatchInfo generateMatchInfo(int ovector[], int ovector_count);
 
+    /**
+     * Runs the pattern over the subject, starting at offset, until no more
+     * matches are found. Every match is appended to info and the last one
+     * is stored in last_info, unless they are NULL.
+     *
+     * @return The number of matches.
+     */
+    int findEveryMatch(const ushort *subject, int length, int offset, QList<MatchInfo> *info, MatchInfo *last_info);
+
     // Store if the pattern is valid.
     bool m_valid;
     // The regular expression as a string.
@@ -155,6 +189,9 @@ private:
     pcre16_extra *m_study;
     // The number of capture subpatterns with the expression.
     int m_captureSubpatternCount;
+    // No match can be empty or contain a line break, so the last
+    // match can be found by scanning back from the end.
+    bool m_matchesStayOnOneLine;
 };
 
 #endif // SPCRE_H
@@ -96,10 +96,17 @@ QStringList HTMLResource::GetLinkedStylesheets()
 }
 
 
-QStringList HTMLResource::SplitOnSGFSectionMarkers()
+XhtmlDoc::SGFSectionSplits HTMLResource::SplitOnSGFSectionMarkers()
 {
-    QStringList sections = XhtmlDoc::GetSGFSectionSplits(GetText());
-    SetText(CleanSource::Clean(sections.takeFirst()));
+    XhtmlDoc::SGFSectionSplits sections = XhtmlDoc::GetSGFSectionSplitOffsets(GetText());
+
+    if (sections.isEmpty()) {
+        return sections;
+    }
+
+    const QString first_section = sections.Section(0);
+    sections.bodies.removeFirst();
+    SetText(CleanSource::Clean(first_section));
     return sections;
 }
 
@@ -27,6 +27,7 @@
 
 #include "Misc/CSSInfo.h"
 #include "BookManipulation/GuideSemantics.h"
+#include "BookManipulation/XhtmlDoc.h"
 #include "ResourceObjects/XMLResource.h"
 
 class QString;
@@ -36,7 +37,7 @@ class QString;
  * Represents an HTML file of the book.
  * Stores several caches of the content for faster access.
  * There's a QWebPage cache that stores the rendered form of
- * the HTML and a QTextDocument cache that stores the syntax
+ * the HTML and a QTextDocument cache (created on demand) that stores the syntax
  * colored version.
  */
 class HTMLResource : public XMLResource
@@ -79,9 +80,9 @@ public:
      * The first section is set as the content of the resource,
      * and the others are returned.
      *
-     * @return The content of all the sections except the first.
+     * @return The split offsets of all the sections except the first.
      */
-    QStringList SplitOnSGFSectionMarkers();
+    XhtmlDoc::SGFSectionSplits SplitOnSGFSectionMarkers();
 
     /**
      * Returns the paths to all the linked resources
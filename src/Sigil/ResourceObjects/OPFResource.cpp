@@ -27,6 +27,7 @@
 #include <QtCore/QBuffer>
 #include <QtCore/QDate>
 #include <QtCore/QFileInfo>
+#include <QtCore/QSet>
 #include <QtCore/QUuid>
 #include <QRegularExpression>
 
@@ -508,6 +509,45 @@ void OPFResource::AddResource(const Resource &resource)
     UpdateTextFromDom(*document);
 }
 
+
+void OPFResource::AddResources(const QList< Resource * > &resources)
+{
+    if (resources.isEmpty()) {
+        return;
+    }
+
+    QWriteLocker locker(&GetLock());
+    shared_ptr< xc::DOMDocument > document = GetDocument();
+    xc::DOMElement *manifest = GetManifestElement(*document);
+    if (!manifest) {
+        return;
+    }
+    // The ids added in this batch are not known to the DOM
+    // until it is reparsed, so we keep track of them here.
+    QSet< QString > added_ids;
+    foreach(Resource * resource, resources) {
+        QString id = GetUniqueID(GetValidID(resource->Filename()), *document);
+
+        if (added_ids.contains(id)) {
+            id = Utility::CreateUUID();
+        }
+
+        added_ids.insert(id);
+        QHash< QString, QString > attributes;
+        attributes[ "id"         ] = id;
+        attributes[ "href"       ] = Utility::URLEncodePath(resource->GetRelativePathToOEBPS());
+        attributes[ "media-type" ] = GetResourceMimetype(*resource);
+        xc::DOMElement *new_item = XhtmlDoc::CreateElementInDocument(
+                                       "item", OPF_XML_NAMESPACE, *document, attributes);
+        manifest->appendChild(new_item);
+
+        if (resource->Type() == Resource::HTMLResourceType) {
+            AppendToSpine(attributes[ "id" ], *document);
+        }
+    }
+    UpdateTextFromDom(*document);
+}
+
 void OPFResource::RemoveCoverMetaForImage(const Resource &resource, xc::DOMDocument &document)
 {
     xc::DOMElement *meta = GetCoverMeta(document);
@@ -135,6 +135,14 @@ public slots:
 
     void AddResource(const Resource &resource);
 
+    /**
+     * Adds several resources to the manifest (and the HTML ones to
+     * the spine) with a single parse and write of the OPF.
+     *
+     * @param resources The resources to add, in the order they should appear.
+     */
+    void AddResources(const QList< Resource * > &resources);
+
     void RemoveCoverMetaForImage(const Resource &resource, xc::DOMDocument &document);
 
     void AddCoverMetaForImage(const Resource &resource, xc::DOMDocument &document);
@@ -35,11 +35,9 @@ TextResource::TextResource(const QString &mainfolder, const QString &fullfilepat
     :
     Resource(mainfolder, fullfilepath, parent),
     m_CacheInUse(false),
-    m_TextDocument(new QTextDocument(this)),
+    m_TextDocument(NULL),
     m_IsLoaded(false)
 {
-    m_TextDocument->setDocumentLayout(new QPlainTextDocumentLayout(m_TextDocument));
-    connect(m_TextDocument, SIGNAL(contentsChanged()), this, SIGNAL(Modified()));
 }
 
 
@@ -51,7 +49,11 @@ QString TextResource::GetText() const
         return m_Cache;
     }
 
-    return m_TextDocument->toPlainText();
+    if (m_TextDocument) {
+        return m_TextDocument->toPlainText();
+    }
+
+    return m_Text;
 }
 
 
@@ -66,12 +68,22 @@ void TextResource::SetText(const QString &text)
     // in the GUI thread).
     //   So we cache the text update into m_Cache and update the QTextDocument
     // when we return to the GUI thread. The single-shot timer makes sure
-    // of that.
+    // of that. If no document exists there is nothing to notify and the
+    // raw text can be replaced directly.
     if (QThread::currentThread() == QApplication::instance()->thread()) {
         SetTextInternal(text);
     } else {
         QMutexLocker locker(&m_CacheAccessMutex);
+
+        if (!m_TextDocument) {
+            SetRawTextLocked(text);
+            locker.unlock();
+            emit Modified();
+            return;
+        }
+
         m_Cache = text;
+        m_Revision.ref();
 
         // We want to make sure we schedule only one delayed update
         if (!m_CacheInUse) {
@@ -84,11 +96,64 @@ void TextResource::SetText(const QString &text)
 
 QTextDocument &TextResource::GetTextDocumentForWriting()
 {
-    Q_ASSERT(m_TextDocument);
+    QMutexLocker locker(&m_CacheAccessMutex);
+
+    if (!m_TextDocument) {
+        QTextDocument *document = new QTextDocument(this);
+        document->setDocumentLayout(new QPlainTextDocumentLayout(document));
+        document->setPlainText(m_Text);
+        document->setModified(false);
+        // From now on the document holds the text
+        m_Text = "";
+        m_TextDocument = document;
+        connect(m_TextDocument, SIGNAL(contentsChanged()), this, SLOT(TextDocumentContentsChanged()));
+    }
+
     return *m_TextDocument;
 }
 
 
+void TextResource::ReleaseTextDocument()
+{
+    if (!m_TextDocument) {
+        return;
+    }
+
+    // Keep the document if the user edited it, otherwise
+    // reopening the tab would lose the undo history.
+    if (m_TextDocument->isUndoAvailable() || m_TextDocument->isRedoAvailable()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_CacheAccessMutex);
+
+    // A delayed update is pending for the document, let it land first.
+    if (m_CacheInUse) {
+        return;
+    }
+
+    m_Text = m_TextDocument->toPlainText();
+    disconnect(m_TextDocument, 0, this, 0);
+    // The editor that was using the document may still be
+    // on its way out, so we can't delete it right now.
+    m_TextDocument->deleteLater();
+    m_TextDocument = NULL;
+}
+
+
+bool TextResource::HasTextDocument() const
+{
+    QMutexLocker locker(&m_CacheAccessMutex);
+    return m_TextDocument != NULL;
+}
+
+
+int TextResource::GetRevision() const
+{
+    return m_Revision.load();
+}
+
+
 void TextResource::SaveToDisk(bool book_wide_save)
 {
     if (!m_IsLoaded) {
@@ -108,7 +173,10 @@ void TextResource::SaveToDisk(bool book_wide_save)
         emit ResourceUpdatedOnDisk();
     }
 
-    m_TextDocument->setModified(false);
+    if (m_TextDocument) {
+        m_TextDocument->setModified(false);
+    }
+
     Resource::SaveToDisk(book_wide_save);
 }
 
@@ -136,9 +204,8 @@ void TextResource::InitialLoad()
       * it had been opened in a tab first.
       */
     QWriteLocker locker(&GetLock());
-    Q_ASSERT(m_TextDocument);
 
-    if (m_TextDocument->toPlainText().isEmpty() && QFile::exists(GetFullPath())) {
+    if (GetText().isEmpty() && QFile::exists(GetFullPath())) {
         SetText(Utility::ReadUnicodeTextFile(GetFullPath()));
     }
 }
@@ -154,7 +221,16 @@ bool TextResource::LoadFromDisk()
     try {
         const QString &text = Utility::ReadUnicodeTextFile(GetFullPath());
         QMutexLocker locker(&m_CacheAccessMutex);
+
+        if (!m_TextDocument) {
+            SetRawTextLocked(text);
+            locker.unlock();
+            emit Modified();
+            return true;
+        }
+
         m_Cache = text;
+        m_Revision.ref();
 
         // We want to make sure we schedule only one delayed update
         if (!m_CacheInUse) {
@@ -183,8 +259,20 @@ void TextResource::DelayedUpdateToTextDocument()
 }
 
 
+void TextResource::TextDocumentContentsChanged()
+{
+    m_Revision.ref();
+    emit Modified();
+}
+
+
 void TextResource::SetTextInternal(const QString &text)
 {
+    if (!m_TextDocument) {
+        SetRawText(text);
+        return;
+    }
+
     m_TextDocument->setPlainText(text);
     m_TextDocument->setModified(false);
     // Clear anything left in the cache
@@ -194,6 +282,24 @@ void TextResource::SetTextInternal(const QString &text)
     m_IsLoaded = true;
 }
 
+void TextResource::SetRawText(const QString &text)
+{
+    {
+        QMutexLocker locker(&m_CacheAccessMutex);
+        SetRawTextLocked(text);
+    }
+    // There is no QTextDocument to fire contentsChanged for us
+    emit Modified();
+}
+
+void TextResource::SetRawTextLocked(const QString &text)
+{
+    m_Text = text;
+    m_Revision.ref();
+    // Our resource has now been loaded with some text
+    m_IsLoaded = true;
+}
+
 bool TextResource::IsLoaded()
 {
     return m_IsLoaded;
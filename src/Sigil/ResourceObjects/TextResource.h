@@ -23,6 +23,7 @@
 #ifndef TEXTRESOURCE_H
 #define TEXTRESOURCE_H
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QMutex>
 
 #include "ResourceObjects/Resource.h"
@@ -32,6 +33,10 @@ class QTextDocument;
 /**
  * A parent class for textual resources like CSS and SVG images.
  * Takes care of loading and caching content etc.
+ *
+ * The raw text is the source of truth until an editor attaches to
+ * the resource. Only then is a QTextDocument created for it, and it
+ * is released again once the editor goes away (if nothing was edited).
  */
 class TextResource : public Resource
 {
@@ -62,14 +67,39 @@ public:
 
     /**
      * Returns a reference to the QTextDocument that can be read and written to
-     * in consumers. If you need just read access, use GetTextDocumentForReading().
+     * in consumers. The document is created from the raw text on first use,
+     * so only call this when an editor actually needs to attach to it.
      *
      * @warning Make sure to get a write lock externally before calling this function!
+     * @warning Must only be called from the main GUI thread.
      *
      * @return A reference to the QTextDocument cache.
      */
     QTextDocument &GetTextDocumentForWriting();
 
+    /**
+     * Drops the QTextDocument once no editor is attached to it anymore,
+     * folding its text back into the raw text store. The document is
+     * kept if it holds undo/redo history, so the user does not lose it
+     * by closing and reopening a tab.
+     *
+     * @warning Must only be called from the main GUI thread.
+     */
+    void ReleaseTextDocument();
+
+    /**
+     * Returns whether a QTextDocument currently exists for this resource.
+     */
+    bool HasTextDocument() const;
+
+    /**
+     * Returns a number that changes every time the text of the resource
+     * changes. Lets consumers cache data derived from the text and only
+     * recompute it for resources that were modified since.
+     * Safe to call from any thread.
+     */
+    int GetRevision() const;
+
     // inherited
     void SaveToDisk(bool book_wide_save = false);
 
@@ -96,15 +126,39 @@ private slots:
      */
     void DelayedUpdateToTextDocument();
 
+    /**
+     * Bumps the revision and announces the
+     * change whenever the QTextDocument is edited.
+     */
+    void TextDocumentContentsChanged();
+
 private:
 
     /**
-     * Actually sets the text to m_TextDocument.
+     * Actually sets the text to m_TextDocument, or to the raw
+     * text store if no document has been created yet.
      *
      * @param text The text to set.
      */
     void SetTextInternal(const QString &text);
 
+    /**
+     * Replaces the raw text store and announces the change.
+     * Only valid while no QTextDocument exists.
+     *
+     * @param text The text to set.
+     */
+    void SetRawText(const QString &text);
+
+    /**
+     * Replaces the raw text store without announcing the change.
+     * The caller must hold m_CacheAccessMutex, so that a QTextDocument
+     * cannot be created between checking for one and storing the text.
+     *
+     * @param text The text to set.
+     */
+    void SetRawTextLocked(const QString &text);
+
 
     ///////////////////////////////
     // PRIVATE MEMBER VARIABLES
@@ -121,15 +175,28 @@ private:
     QString m_Cache;
 
     /**
-     * The access mutex for the cache.
+     * The access mutex for the cache, the raw text and
+     * the m_TextDocument pointer.
      */
     mutable QMutex m_CacheAccessMutex;
 
+    /**
+     * The raw text of the resource. Authoritative
+     * only while m_TextDocument is NULL.
+     */
+    QString m_Text;
+
     /**
      * The syntax colored cache of the TextResource text content.
+     * Created lazily when an editor attaches, NULL otherwise.
      */
     QTextDocument *m_TextDocument;
 
+    /**
+     * Incremented on every change to the text. @see GetRevision().
+     */
+    QAtomicInt m_Revision;
+
     bool m_IsLoaded;
 };
 
@@ -19,6 +19,8 @@
 **
 *************************************************************************/
 
+#include <QtConcurrent/QtConcurrent>
+
 #include "BookManipulation/CleanSource.h"
 #include "BookManipulation/XhtmlDoc.h"
 #include "Misc/Utility.h"
@@ -26,11 +28,20 @@
 
 
 XMLResource::XMLResource(const QString &mainfolder, const QString &fullfilepath, QObject *parent)
-    : TextResource(mainfolder, fullfilepath, parent)
+    : TextResource(mainfolder, fullfilepath, parent),
+      m_WellFormedRevision(-1),
+      m_WellFormedCheckRevision(-1)
 {
 }
 
 
+XMLResource::~XMLResource()
+{
+    // The background check calls back into this object
+    m_WellFormedCheck.waitForFinished();
+}
+
+
 Resource::ResourceType XMLResource::Type() const
 {
     return Resource::XMLResourceType;
@@ -40,17 +51,75 @@ Resource::ResourceType XMLResource::Type() const
 bool XMLResource::FileIsWellFormed() const
 {
     // TODO: expand this with a dialog to fix the problem
-    QReadLocker locker(&GetLock());
-    XhtmlDoc::WellFormedError error = XhtmlDoc::WellFormedErrorForSource(GetText());
+    XhtmlDoc::WellFormedError error = WellFormedErrorLocation();
     bool well_formed = error.line == -1;
     return well_formed;
 }
 
 
 XhtmlDoc::WellFormedError XMLResource::WellFormedErrorLocation() const
+{
+    QString text;
+    int revision;
+    QFuture< XhtmlDoc::WellFormedError > running_check;
+    bool wait_for_check = false;
+    {
+        QReadLocker locker(&GetLock());
+        // The revision is read first. If the text changes before we
+        // read it, the result is stored under an outdated revision
+        // and will simply never be used.
+        revision = GetRevision();
+        QMutexLocker cache_locker(&m_WellFormedMutex);
+
+        if (m_WellFormedRevision == revision) {
+            return m_WellFormedError;
+        }
+
+        if (m_WellFormedCheckRevision == revision) {
+            running_check = m_WellFormedCheck;
+            wait_for_check = true;
+        } else {
+            text = GetText();
+        }
+    }
+
+    if (wait_for_check) {
+        return running_check.result();
+    }
+
+    return CheckWellFormed(text, revision);
+}
+
+
+void XMLResource::CheckWellFormedInBackground() const
 {
     QReadLocker locker(&GetLock());
-    return XhtmlDoc::WellFormedErrorForSource(GetText());
+    int revision = GetRevision();
+    QMutexLocker cache_locker(&m_WellFormedMutex);
+
+    if (m_WellFormedRevision == revision || m_WellFormedCheckRevision == revision) {
+        return;
+    }
+
+    // The text is read here as the QTextDocument
+    // must not be touched from the worker thread.
+    m_WellFormedCheck = QtConcurrent::run(this, &XMLResource::CheckWellFormed, GetText(), revision);
+    m_WellFormedCheckRevision = revision;
+}
+
+
+XhtmlDoc::WellFormedError XMLResource::CheckWellFormed(const QString &text, int revision) const
+{
+    XhtmlDoc::WellFormedError error = XhtmlDoc::WellFormedErrorForSource(text);
+    QMutexLocker cache_locker(&m_WellFormedMutex);
+
+    // Never replace the result for newer text with that of older text
+    if (revision >= m_WellFormedRevision) {
+        m_WellFormedRevision = revision;
+        m_WellFormedError = error;
+    }
+
+    return error;
 }
 
 
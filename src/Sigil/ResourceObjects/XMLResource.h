@@ -23,6 +23,9 @@
 #ifndef XMLRESOURCE_H
 #define XMLRESOURCE_H
 
+#include <QtCore/QFuture>
+#include <QtCore/QMutex>
+
 #include "BookManipulation/XercesHUse.h"
 #include "BookManipulation/XhtmlDoc.h"
 #include "ResourceObjects/TextResource.h"
@@ -43,14 +46,31 @@ public:
      */
     XMLResource(const QString &mainfolder, const QString &fullfilepath, QObject *parent = NULL);
 
+    ~XMLResource();
+
     // inherited
 
     virtual ResourceType Type() const;
 
     bool FileIsWellFormed() const;
 
+    /**
+     * Returns the first well-formed error in the text of the resource.
+     * The result is cached until the text changes, and if a background
+     * check of the current text is running we wait for it instead of
+     * parsing the text again.
+     */
     XhtmlDoc::WellFormedError WellFormedErrorLocation() const;
 
+    /**
+     * Starts checking the current text on a worker thread, so that a
+     * later call to WellFormedErrorLocation() finds the answer ready.
+     * Does nothing if the result for the current text is already known.
+     *
+     * @warning Must only be called from the main GUI thread.
+     */
+    void CheckWellFormedInBackground() const;
+
 protected:
 
     void UpdateTextFromDom(const xc::DOMDocument &document);
@@ -72,6 +92,34 @@ protected:
      */
     static bool IsValidIDCharacter(const QChar &character);
 
+private:
+
+    /**
+     * Runs the check on a worker thread and caches the result.
+     */
+    XhtmlDoc::WellFormedError CheckWellFormed(const QString &text, int revision) const;
+
+    ///////////////////////////////
+    // PRIVATE MEMBER VARIABLES
+    ///////////////////////////////
+
+    /**
+     * Guards the cached result and the background check.
+     */
+    mutable QMutex m_WellFormedMutex;
+
+    /**
+     * The text revision m_WellFormedError belongs to, or -1.
+     */
+    mutable int m_WellFormedRevision;
+
+    mutable XhtmlDoc::WellFormedError m_WellFormedError;
+
+    /**
+     * The running (or last) background check and the text revision it checks.
+     */
+    mutable QFuture< XhtmlDoc::WellFormedError > m_WellFormedCheck;
+    mutable int m_WellFormedCheckRevision;
 };
 
 #endif // XMLRESOURCE_H
@@ -422,6 +422,14 @@ signals:
     void MarkSelectionRequest();
     void ClearMarkedTextRequest();
 
+    /**
+     * Emitted when IsLoadingFinished() becomes true after the
+     * tab has been loading its content.
+     *
+     * Tabs whose content is always loaded never emit this.
+     */
+    void LoadingFinished();
+
 protected slots:
 
     /**
@@ -129,6 +129,9 @@ FlowTab::~FlowTab()
         delete(m_views);
         m_views = 0;
     }
+
+    // No editor needs the resource's text document anymore.
+    m_HTMLResource.ReleaseTextDocument();
 }
 
 void FlowTab::CreateBookViewIfRequired(bool is_delayed_load)
@@ -219,6 +222,7 @@ void FlowTab::DelayedInitialization()
     DelayedConnectSignalsToSlots();
     // Cursor set in constructor
     QApplication::restoreOverrideCursor();
+    EmitLoadingFinishedIfDone();
 }
 
 MainWindow::ViewState FlowTab::GetViewState()
@@ -388,7 +392,10 @@ void FlowTab::SaveTabContent()
     }
 
     // Either from being in CV or saving from BV above we now reset the resource to say no user changes unsaved.
-    m_HTMLResource.GetTextDocumentForWriting().setModified(false);
+    // Only CV attaches the text document, so there is nothing to reset (or create) without it.
+    if (m_wCodeView) {
+        m_wCodeView->document()->setModified(false);
+    }
 }
 
 void FlowTab::ResourceModified()
@@ -492,6 +499,13 @@ void FlowTab::EmitUpdatePreviewImmediately()
     emit UpdatePreviewImmediately();
 }
 
+void FlowTab::EmitLoadingFinishedIfDone()
+{
+    if (!m_initialLoad && IsLoadingFinished()) {
+        emit LoadingFinished();
+    }
+}
+
 void FlowTab::EmitUpdateCursorPosition()
 {
     emit UpdateCursorPosition(GetCursorLine(), GetCursorColumn());
@@ -862,12 +876,9 @@ bool FlowTab::IsDataWellFormed()
     } else {
         // We are in PV or CV. In either situation the xhtml from CV could be invalid as the user may
         // have switched to PV to preview it (as they are allowed to do).
-        // It is also possible that they opened the tab in PV as the initial load and CV is not loaded.
-        // We are doing a well formed check, but we can only do it on the CV text if CV has been loaded.
-        // So lets play safe and have a fallback to use the resource text if CV is not loaded yet.
-        XhtmlDoc::WellFormedError error = (m_wCodeView != NULL)
-                                          ? XhtmlDoc::WellFormedErrorForSource(m_wCodeView->toPlainText())
-                                          : XhtmlDoc::WellFormedErrorForSource(m_HTMLResource.GetText());
+        // CV edits the QTextDocument of the resource directly, so checking the resource
+        // covers both cases and lets us reuse the cached (or background) result.
+        XhtmlDoc::WellFormedError error = m_HTMLResource.WellFormedErrorLocation();
         m_safeToLoad = error.line == -1;
 
         if (!m_safeToLoad) {
@@ -1530,6 +1541,7 @@ void FlowTab::ConnectBookViewSignalsToSlots()
     connect(m_wBookView, SIGNAL(PageClicked()), this, SLOT(EmitUpdatePreviewImmediately()));
     connect(m_wBookView, SIGNAL(PageOpened()), this, SLOT(EmitUpdatePreviewImmediately()));
     connect(m_wBookView, SIGNAL(DocumentLoaded()), this, SLOT(EmitUpdatePreviewImmediately()));
+    connect(m_wBookView, SIGNAL(DocumentLoaded()), this, SLOT(EmitLoadingFinishedIfDone()));
 }
 
 void FlowTab::ConnectCodeViewSignalsToSlots()
@@ -1551,6 +1563,7 @@ void FlowTab::ConnectCodeViewSignalsToSlots()
     connect(m_wCodeView, SIGNAL(PageUpdated()), this, SLOT(EmitUpdatePreview()));
     connect(m_wCodeView, SIGNAL(PageClicked()), this, SLOT(EmitUpdatePreviewImmediately()));
     connect(m_wCodeView, SIGNAL(DocumentSet()), this, SLOT(EmitUpdatePreviewImmediately()));
+    connect(m_wCodeView, SIGNAL(DocumentSet()), this, SLOT(EmitLoadingFinishedIfDone()));
     connect(m_wCodeView, SIGNAL(MarkSelectionRequest()), this, SIGNAL(MarkSelectionRequest()));
     connect(m_wCodeView, SIGNAL(ClearMarkedTextRequest()), this, SIGNAL(ClearMarkedTextRequest()));
 }
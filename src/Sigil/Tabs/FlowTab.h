@@ -327,6 +327,12 @@ private slots:
     void EmitUpdatePreview();
     void EmitUpdatePreviewImmediately();
 
+    /**
+     * Emits LoadingFinished once the initial load is done
+     * and every created view has finished loading.
+     */
+    void EmitLoadingFinishedIfDone();
+
     void EmitUpdateCursorPosition();
 
     /**
@@ -304,6 +304,10 @@ void TabManager::EmitTabChanged()
     ContentTab *current_tab = qobject_cast< ContentTab * >(currentWidget());
 
     if (m_LastContentTab.data() != current_tab) {
+        // Get the well-formed checks of both tabs out of the way
+        // while the user is looking at the new one.
+        CheckWellFormedInBackground(m_LastContentTab.data());
+        CheckWellFormedInBackground(current_tab);
         emit TabChanged(m_LastContentTab.data(), current_tab);
         m_LastContentTab = QPointer< ContentTab >(current_tab);
     }
@@ -355,6 +359,20 @@ WellFormedContent *TabManager::GetWellFormedContent(int index)
 }
 
 
+void TabManager::CheckWellFormedInBackground(ContentTab *tab)
+{
+    if (!tab || !dynamic_cast< WellFormedContent * >(tab)) {
+        return;
+    }
+
+    XMLResource *xml_resource = qobject_cast< XMLResource * >(&tab->GetLoadedResource());
+
+    if (xml_resource) {
+        xml_resource->CheckWellFormedInBackground();
+    }
+}
+
+
 
 // Returns the index of the tab the index is loaded in, -1 if it isn't
 int TabManager::ResourceTabIndex(const Resource &resource) const
@@ -225,6 +225,14 @@ private:
      */
     WellFormedContent *GetWellFormedContent(int index);
 
+    /**
+     * Starts the well-formed check of the resource shown in the tab
+     * on a worker thread, if the tab holds well-formed XML data.
+     *
+     * @param tab The tab. Can be NULL.
+     */
+    static void CheckWellFormedInBackground(ContentTab *tab);
+
     /**
      * Returns the index of tab in which the resource is loaded.
      * If the resource is not currently loaded, -1 is returned.
@@ -50,6 +50,13 @@ TextTab::TextTab(TextResource &resource,
 }
 
 
+TextTab::~TextTab()
+{
+    // No editor needs the resource's text document anymore.
+    m_TextResource.ReleaseTextDocument();
+}
+
+
 void TextTab::ScrollToLine(int line)
 {
     m_wCodeView.ScrollToLine(line);
@@ -43,6 +43,8 @@ public:
             int line_to_scroll_to = -1,
             QWidget *parent = 0);
 
+    ~TextTab();
+
     void ScrollToLine(int line);
 
     // Overrides inherited from ContentTab
@@ -0,0 +1,122 @@
+/************************************************************************
+**
+**  Copyright (C) 2026  agent <agent@local>
+**
+**  This file is part of Sigil.
+**
+**  Sigil is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  Sigil is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with Sigil.  If not, see <http://www.gnu.org/licenses/>.
+**
+*************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "PCRE/SPCRE.h"
+
+/**
+ * Checks that the windowed backward search of SPCRE::getLastMatchInfo
+ * always finds the last of the matches a scan of the whole text finds.
+ */
+class TestSPCRE : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void LastMatch_data();
+    void LastMatch();
+    void LastMatchInRange();
+
+private:
+    // Many short lines, far more than the first window holds
+    static QString Filler(int lines);
+};
+
+QString TestSPCRE::Filler(int lines)
+{
+    QString filler;
+
+    for (int i = 0; i < lines; i++) {
+        filler.append("<p>Some filler text on line ").append(QString::number(i)).append("</p>\n");
+    }
+
+    return filler;
+}
+
+void TestSPCRE::LastMatch_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("text");
+    const QString filler = Filler(2000);
+    // Anchored patterns
+    QTest::newRow("start of text") << "\\Abar" << "bar\n" + filler;
+    QTest::newRow("start of line") << "^bar" << "bar\n" + filler + "foo bar\n";
+    QTest::newRow("end of line") << "bar$" << "bar\n" + filler + "bar foo\n";
+    QTest::newRow("end of text") << "foo\\z" << "foo\n" + filler + "foo";
+    // Lookbehinds that look at text before the window
+    QTest::newRow("lookbehind") << "(?<=ab)c" << "abc\n" + filler + "xc\n";
+    QTest::newRow("negative lookbehind") << "(?<!a)c" << "bc\n" + filler + "ac\n";
+    QTest::newRow("lookbehind at line start") << "(?<=^)foo" << "foo\n" + filler;
+    // Matches that span a window boundary
+    QTest::newRow("long line") << "y+" << QString(20000, QChar('y')) + "\n" + filler.left(100);
+    QTest::newRow("long line at end") << "y+" << filler + QString(20000, QChar('y'));
+    QTest::newRow("dotall") << "(?s)<div.*?</div>" << "<div>\n" + filler + "<div>inner</div></div>";
+    QTest::newRow("greedy dotall") << "(?s)<div.*</div>" << "<div>\n" + filler + "<div>inner</div>";
+    QTest::newRow("negated class") << "[^<]+" << "<b>" + filler + "</b>";
+    QTest::newRow("whitespace") << "p>\\s+<" << filler;
+    QTest::newRow("line break") << "\\n<p>S" << filler;
+    // Empty matches end a scan
+    QTest::newRow("empty match") << "z*" << filler + "zzz";
+    QTest::newRow("empty match later") << "p|(?=S)" << filler;
+    // Backreferences and \G depend on earlier matches
+    QTest::newRow("backreference") << "(<p>)S.*?\\1" << filler;
+    QTest::newRow("contiguous") << "\\G<p>" << "<p><p>\n" + filler + "<p>";
+    // No match at all
+    QTest::newRow("no match") << "nothing" << filler;
+    QTest::newRow("match at start only") << "Some filler text on line 0<" << filler;
+}
+
+void TestSPCRE::LastMatch()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, text);
+    SPCRE spcre(pattern);
+    QVERIFY(spcre.isValid());
+    QList<SPCRE::MatchInfo> every_match = spcre.getEveryMatchInfo(text);
+    SPCRE::MatchInfo expected;
+
+    if (!every_match.isEmpty()) {
+        expected = every_match.last();
+    }
+
+    SPCRE::MatchInfo last_match = spcre.getLastMatchInfo(text);
+    QCOMPARE(last_match.offset.first, expected.offset.first);
+    QCOMPARE(last_match.offset.second, expected.offset.second);
+    QCOMPARE(last_match.capture_groups_offsets, expected.capture_groups_offsets);
+}
+
+void TestSPCRE::LastMatchInRange()
+{
+    const QString text = Filler(2000);
+    SPCRE spcre("line \\d+<");
+    int start = text.indexOf("line 10<");
+    int end = text.indexOf("line 1500<") + 5;
+    QList<SPCRE::MatchInfo> every_match = spcre.getEveryMatchInfo(text.mid(start, end - start));
+    QVERIFY(!every_match.isEmpty());
+    SPCRE::MatchInfo last_match = spcre.getLastMatchInfo(text, start, end);
+    QCOMPARE(last_match.offset.first, every_match.last().offset.first);
+    QCOMPARE(last_match.offset.second, every_match.last().offset.second);
+}
+
+QTEST_APPLESS_MAIN(TestSPCRE)
+
+#include "TestSPCRE.moc"
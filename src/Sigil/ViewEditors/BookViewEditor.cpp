@@ -80,6 +80,7 @@ BookViewEditor::BookViewEditor(QWidget *parent)
     :
     BookViewPreview(parent),
     m_WebPageModified(false),
+    m_HtmlCacheRevision(-1),
     m_clipMapper(new QSignalMapper(this)),
     m_OpenWithContextMenu(*new QMenu(this)),
     m_PageUp(*(new QShortcut(QKeySequence(QKeySequence::MoveToPreviousPage), this, 0, 0, Qt::WidgetShortcut))),
@@ -180,6 +181,12 @@ void BookViewEditor::CustomSetDocument(const QString &path, const QString &html)
 
 QString BookViewEditor::GetHtml()
 {
+    // Serializing and cleaning the page is expensive,
+    // so only do it again once the page has changed.
+    if (m_HtmlCacheRevision == GetPageRevision()) {
+        return m_HtmlCache;
+    }
+
     RemoveWebkitCruft();
     // Set the xml tag here rather than let Tidy do it.
     // This prevents false mismatches with the cache later on.
@@ -197,6 +204,12 @@ QString BookViewEditor::GetHtml()
         html_from_Qt.insert(empty_body_tag_end, "\n  <p>&nbsp;</p>");
     };
 
+    // The page is still loading, so what we have now will not last.
+    if (m_isLoadFinished) {
+        m_HtmlCache = html_from_Qt;
+        m_HtmlCacheRevision = GetPageRevision();
+    }
+
     return html_from_Qt;
 }
 
@@ -416,6 +416,12 @@ private:
      */
     bool m_WebPageModified;
 
+    /**
+     * The source GetHtml returned for m_HtmlCacheRevision of the page.
+     */
+    QString m_HtmlCache;
+    int m_HtmlCacheRevision;
+
     QSignalMapper *m_clipMapper;
 
     /**
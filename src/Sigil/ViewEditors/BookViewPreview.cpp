@@ -61,7 +61,9 @@ BookViewPreview::BookViewPreview(QWidget *parent)
       m_CaretLocationUpdate(QString()),
       m_pendingLoadCount(0),
       m_pendingScrollToFragment(QString()),
-      m_Inspector(NULL)
+      m_Inspector(NULL),
+      m_PageRevision(0),
+      m_SearchToolsRevision(-1)
 {
     setContextMenuPolicy(Qt::CustomContextMenu);
     // Set the Zoom factor but be sure no signals are set because of this.
@@ -237,11 +239,10 @@ bool BookViewPreview::FindNext(const QString &search_regex,
                                bool wrap,
                                bool selected_text)
 {
-    SearchTools search_tools = GetSearchTools();
-    return FindNext(search_tools, search_regex, search_direction, check_spelling, ignore_selection_offset, wrap, selected_text);
+    return FindNext(GetSearchTools(), search_regex, search_direction, check_spelling, ignore_selection_offset, wrap, selected_text);
 }
 
-bool BookViewPreview::FindNext(SearchTools &search_tools,
+bool BookViewPreview::FindNext(const SearchTools &search_tools,
                                const QString &search_regex,
                                Searchable::Direction search_direction,
                                bool check_spelling,
@@ -268,7 +269,7 @@ bool BookViewPreview::FindNext(SearchTools &search_tools,
             selection_offset = GetSelectionOffset(*search_tools.document, search_tools.node_offsets, search_direction);
         }
 
-        match_info = spcre->getLastMatchInfo(Utility::Substring(0, selection_offset, search_tools.fulltext));
+        match_info = spcre->getLastMatchInfo(search_tools.fulltext, 0, selection_offset);
     } else {
         if (ignore_selection_offset) {
             selection_offset = 0;
@@ -396,6 +397,18 @@ void BookViewPreview::WebPageJavascriptOnLoad()
 }
 
 
+void BookViewPreview::IncrementPageRevision()
+{
+    m_PageRevision++;
+}
+
+
+int BookViewPreview::GetPageRevision() const
+{
+    return m_PageRevision;
+}
+
+
 int BookViewPreview::GetLocalSelectionOffset(bool start_of_selection)
 {
     int anchor_offset = EvaluateJavascript("document.getSelection().anchorOffset;").toInt();
@@ -448,10 +461,16 @@ int BookViewPreview::GetSelectionOffset(const xc::DOMDocument &document,
 }
 
 
-BookViewPreview::SearchTools BookViewPreview::GetSearchTools() const
+const BookViewPreview::SearchTools &BookViewPreview::GetSearchTools()
 {
-    SearchTools search_tools;
+    // Repeated searches on an unchanged page reuse the parsed DOM.
+    if (m_SearchToolsRevision == m_PageRevision) {
+        return m_SearchTools;
+    }
+
+    SearchTools &search_tools = m_SearchTools;
     search_tools.fulltext = "";
+    search_tools.node_offsets.clear();
     search_tools.document = XhtmlDoc::LoadTextIntoDocument(page()->mainFrame()->toHtml());
     QList< xc::DOMNode * > text_nodes = XhtmlDoc::GetVisibleTextNodes(
                                             *(search_tools.document->getElementsByTagName(QtoX("body"))->item(0)));
@@ -475,6 +494,7 @@ BookViewPreview::SearchTools BookViewPreview::GetSearchTools() const
         }
     }
 
+    m_SearchToolsRevision = m_PageRevision;
     return search_tools;
 }
 
@@ -739,4 +759,6 @@ void BookViewPreview::ConnectSignalsToSlots()
     connect(page(), SIGNAL(loadProgress(int)), this, SLOT(UpdateFinishedState(int)));
     connect(page(), SIGNAL(linkClicked(const QUrl &)), SIGNAL(LinkClicked(const QUrl &)));
     connect(page(), SIGNAL(loadFinished(bool)), this, SLOT(WebPageJavascriptOnLoad()));
+    connect(page(), SIGNAL(loadStarted()), this, SLOT(IncrementPageRevision()));
+    connect(page(), SIGNAL(contentsChanged()), this, SLOT(IncrementPageRevision()));
 }
@@ -161,6 +161,11 @@ protected:
      */
     QVariant EvaluateJavascript(const QString &javascript);
 
+    /**
+     * Returns a number that changes whenever the page is loaded or edited.
+     */
+    int GetPageRevision() const;
+
     /**
      * Javascript source that implements a function to find the
      * first block-level parent of a node in the source.
@@ -198,6 +203,12 @@ private slots:
      */
     void WebPageJavascriptOnLoad();
 
+    /**
+     * Marks the page as modified, so the SearchTools
+     * are rebuilt on the next search.
+     */
+    void IncrementPageRevision();
+
     void executeCaretUpdateInternal() {
         ExecuteCaretUpdate();
     }
@@ -279,11 +290,9 @@ private:
     };
 
     /**
-     * Private overload for FindNext that allows it to return (by reference) the SearchTools object
-     * it creates so that the DOM doesn't need to be parsed again when ReplaceSelected is called immediately
-     * after.
+     * Private overload for FindNext that searches with the given SearchTools.
      */
-    bool FindNext(SearchTools &search_tools,
+    bool FindNext(const SearchTools &search_tools,
                   const QString &search_regex,
                   Searchable::Direction search_direction,
                   bool check_spelling = false,
@@ -364,11 +373,12 @@ private:
 
     /**
      * Returns the all the necessary tools for searching.
-     * Reads from the QWebPage source.
+     * Reads from the QWebPage source, but only when the
+     * page has changed since the last call.
      *
      * @return The necessary tools for searching.
      */
-    SearchTools GetSearchTools() const;
+    const SearchTools &GetSearchTools();
 
     void CreateContextMenuActions();
 
@@ -450,6 +460,17 @@ private:
     QAction *m_InspectElement;
 
     QWebInspector *m_Inspector;
+
+    /**
+     * Incremented whenever the page is loaded or edited.
+     */
+    int m_PageRevision;
+
+    /**
+     * The SearchTools built for m_SearchToolsRevision of the page.
+     */
+    SearchTools m_SearchTools;
+    int m_SearchToolsRevision;
 };
 
 #endif // BOOKVIEWPREVIEW_H
@@ -63,7 +63,6 @@ using boost::tuple;
 static const int TAB_SPACES_WIDTH        = 4;
 static const int LINE_NUMBER_MARGIN      = 5;
 
-static const QString XML_OPENING_TAG        = "(<[^>/][^>]*[^>/]>|<[^>/]>)";
 static const QString NEXT_CLOSE_TAG_LOCATION = "</\\s*[^>]+>";
 static const QString NEXT_TAG_LOCATION      = "<[^!>]+>";
 static const QString TAG_NAME_SEARCH        = "<\\s*([^\\s>]+)";
@@ -90,6 +89,10 @@ CodeViewEditor::CodeViewEditor(HighlighterType high_type, bool check_spelling, Q
     m_reformatCSSEnabled(false),
     m_reformatHTMLEnabled(false),
     m_lastFindRegex(QString()),
+    m_SearchTextDocument(NULL),
+    m_ElementOffsetsValid(false),
+    m_ElementOffsetsRoot(-1),
+    m_ElementOffsetsError(-1),
     m_spellingMapper(new QSignalMapper(this)),
     m_addSpellingMapper(new QSignalMapper(this)),
     m_addDictMapper(new QSignalMapper(this)),
@@ -130,6 +133,7 @@ QSize CodeViewEditor::sizeHint() const
 void CodeViewEditor::CustomSetDocument(QTextDocument &document)
 {
     setDocument(&document);
+    ResetTextCaches();
     document.setModified(false);
 
     if (m_Highlighter) {
@@ -195,12 +199,12 @@ void CodeViewEditor::HighlightMarkedText()
     selection.format.setFontUnderline(QTextCharFormat::DotLine);
     selection.cursor.clearSelection();
     selection.cursor.setPosition(0);
-    selection.cursor.setPosition(toPlainText().length());
+    selection.cursor.setPosition(GetDocumentLength());
     extraSelections.append(selection);
     setExtraSelections(extraSelections);
     extraSelections.clear();
 
-    if (m_MarkedTextStart < 0 || m_MarkedTextEnd > toPlainText().length()) {
+    if (m_MarkedTextStart < 0 || m_MarkedTextEnd > GetDocumentLength()) {
         return;
     }
     selection.format.setFontUnderline(QTextCharFormat::DotLine);
@@ -711,9 +715,10 @@ bool CodeViewEditor::FindNext(const QString &search_regex,
 {
     SPCRE *spcre = PCRECache::instance()->getObject(search_regex);
     SPCRE::MatchInfo match_info;
+    const QString text = GetSearchText();
     int start_offset = 0;
     int start = 0;
-    int end = toPlainText().length();
+    int end = text.length();
     if (marked_text) {
         if (!MoveToMarkedText(search_direction, wrap)) {
             return false;
@@ -726,15 +731,15 @@ bool CodeViewEditor::FindNext(const QString &search_regex,
 
     if (search_direction == Searchable::Direction_Up) {
         if (misspelled_words) {
-            match_info = GetMisspelledWord(toPlainText(), 0, selection_offset, search_regex, search_direction);
+            match_info = GetMisspelledWord(text, 0, selection_offset, search_regex, search_direction);
         } else {
-            match_info = spcre->getLastMatchInfo(Utility::Substring(start, selection_offset, toPlainText()));
+            match_info = spcre->getLastMatchInfo(text, start, selection_offset);
         }
     } else {
         if (misspelled_words) {
-            match_info = GetMisspelledWord(toPlainText(), selection_offset, toPlainText().count(), search_regex, search_direction);
+            match_info = GetMisspelledWord(text, selection_offset, text.count(), search_regex, search_direction);
         } else {
-            match_info = spcre->getFirstMatchInfo(Utility::Substring(selection_offset, end, toPlainText()));
+            match_info = spcre->getFirstMatchInfo(text, selection_offset, end);
         }
 
         start_offset = selection_offset;
@@ -773,8 +778,7 @@ bool CodeViewEditor::FindNext(const QString &search_regex,
 int CodeViewEditor::Count(const QString &search_regex, Searchable::Direction direction, bool wrap, bool marked_text)
 {
     SPCRE *spcre = PCRECache::instance()->getObject(search_regex);
-    QString text;
-    text = toPlainText();
+    const QString text = GetSearchText();
     int start = 0;
     int end = text.length();
 
@@ -787,15 +791,12 @@ int CodeViewEditor::Count(const QString &search_regex, Searchable::Direction dir
     }
     if (!wrap) {
         if (direction == Searchable::Direction_Up) {
-            text = Utility::Substring(start, textCursor().position(), text);
+            end = textCursor().position();
         } else {
-            text = Utility::Substring(textCursor().position(), end, text);
+            start = textCursor().position();
         }
     }
-    else if (marked_text) {
-        text = Utility::Substring(start, end, text);
-    }
-    return spcre->getEveryMatchInfo(text).count();
+    return spcre->countMatches(text, start, end);
 }
 
 
@@ -964,6 +965,25 @@ void CodeViewEditor::ResetLastFindMatch()
     m_lastMatch.offset.first = -1;
 }
 
+void CodeViewEditor::ResetTextCaches()
+{
+    m_SearchTextDocument = NULL;
+    m_SearchText.clear();
+    m_ElementOffsetsValid = false;
+    m_ElementOffsets.clear();
+    m_ElementChildren.clear();
+}
+
+QString CodeViewEditor::GetSearchText()
+{
+    if (m_SearchTextDocument != document()) {
+        m_SearchText = toPlainText();
+        m_SearchTextDocument = document();
+    }
+
+    return m_SearchText;
+}
+
 QString CodeViewEditor::GetSelectedText()
 {
     return textCursor().selectedText();
@@ -1881,8 +1901,35 @@ void CodeViewEditor::UpdateLineNumberArea(const QRect &area_to_update, int verti
 }
 
 
+int CodeViewEditor::GetDocumentLength() const
+{
+    // The document always ends with a paragraph separator
+    // that is not part of the plain text.
+    return document()->characterCount() - 1;
+}
+
+
 void CodeViewEditor::HighlightCurrentLine()
 {
+    if (IsMarkedText() && m_MarkedTextEnd > GetDocumentLength()) {
+        m_MarkedTextEnd = GetDocumentLength();
+    }
+
+    // This runs on every cursor move. The cursors of the extra selections
+    // follow edits, so nothing has to change unless the caret moved to
+    // another line or the marked text changed.
+    QList< QTextEdit::ExtraSelection > current_selections = extraSelections();
+
+    if (current_selections.count() == (IsMarkedText() ? 2 : 1) &&
+        current_selections.at(0).format.property(QTextFormat::FullWidthSelection).toBool() &&
+        current_selections.at(0).cursor.document() == document() &&
+        current_selections.at(0).cursor.blockNumber() == textCursor().blockNumber() &&
+        (!IsMarkedText() ||
+         (current_selections.at(1).cursor.selectionStart() == m_MarkedTextStart &&
+          current_selections.at(1).cursor.selectionEnd() == m_MarkedTextEnd))) {
+        return;
+    }
+
     QList< QTextEdit::ExtraSelection > extraSelections;
 
     // Draw the full width line color.
@@ -1895,10 +1942,6 @@ void CodeViewEditor::HighlightCurrentLine()
 
     // Add highlighting of the marked text
     if (IsMarkedText()) {
-        if (m_MarkedTextEnd > toPlainText().length()) {
-            m_MarkedTextEnd = toPlainText().length();
-        }
-
         QTextEdit::ExtraSelection selection;
         selection.format.setBackground(m_codeViewAppearance.line_number_background_color);
         selection.cursor = textCursor();
@@ -2157,26 +2200,43 @@ void CodeViewEditor::ScrollByLine(bool down)
 
 QList< ViewEditor::ElementIndex > CodeViewEditor::GetCaretLocation()
 {
-    // We search for the first opening tag *behind* the caret.
-    // This specifies the element the caret is located in.
+    // The element the caret is located in is the
+    // one with the last start tag *behind* the caret.
     int pos = textCursor().position();
-    int offset = 0;
-    int len = 0;
-    QRegularExpression tag(XML_OPENING_TAG);
-    QRegularExpressionMatchIterator i = tag.globalMatch(toPlainText());
-    // There is no way to search for the last match (str.lastIndexOf) in a string and also have
-    // the matched text length. So we search forward for every match (QRegularExpression doen't
-    // have a way to search backwards) and only use the last match's info.
-    while (i.hasNext()) {
-        QRegularExpressionMatch mo = i.next();
-        int start = mo.capturedStart();
-        if (start > pos) {
-            break;
+    QList< ViewEditor::ElementIndex > hierarchy;
+    UpdateElementOffsets();
+
+    if (m_ElementOffsetsError != -1 && pos >= m_ElementOffsetsError) {
+        return hierarchy;
+    }
+
+    // Binary search for the first start tag after the caret
+    int low = 0;
+    int high = m_ElementOffsets.count();
+
+    while (low < high) {
+        int middle = (low + high) / 2;
+
+        if (m_ElementOffsets.at(middle).tag_start <= pos) {
+            low = middle + 1;
+        } else {
+            high = middle;
         }
-        offset = start;
-        len = mo.capturedLength();
     }
-    return ConvertStackToHierarchy(GetCaretLocationStack(offset + len));
+
+    // Walk up to the root. Every element is listed with the index of
+    // the child on the path, and the innermost element with -1.
+    int child_index = -1;
+
+    for (int element = low - 1; element != -1; element = m_ElementOffsets.at(element).parent) {
+        ViewEditor::ElementIndex new_element;
+        new_element.name  = m_ElementOffsets.at(element).name;
+        new_element.index = child_index;
+        hierarchy.prepend(new_element);
+        child_index = m_ElementOffsets.at(element).child_index;
+    }
+
+    return hierarchy;
 }
 
 
@@ -2186,61 +2246,118 @@ void CodeViewEditor::StoreCaretLocationUpdate(const QList< ViewEditor::ElementIn
 }
 
 
-QStack< CodeViewEditor::StackElement > CodeViewEditor::GetCaretLocationStack(int offset) const
+void CodeViewEditor::UpdateElementOffsets()
 {
-    QString source = toPlainText();
+    if (m_ElementOffsetsValid) {
+        return;
+    }
+
+    const QString source = GetSearchText();
     QXmlStreamReader reader(source);
-    QStack< StackElement > stack;
+    QVector< int > open_elements;
+    m_ElementOffsets.clear();
+    m_ElementChildren.clear();
+    m_ElementOffsetsRoot = -1;
+    m_ElementOffsetsError = -1;
 
     while (!reader.atEnd()) {
         reader.readNext();
 
         if (reader.isStartElement()) {
-            // If we detected the start of a new element, then
-            // the element currently on the top of the stack
-            // has one more child element
-            if (!stack.isEmpty()) {
-                stack.top().num_children++;
+            ElementOffset element;
+            element.name           = reader.name().toString();
+            element.tag_end        = reader.characterOffset();
+            // Well formed attribute values cannot contain a '<'
+            element.tag_start      = source.lastIndexOf(QChar('<'), element.tag_end - 1);
+            element.parent         = open_elements.isEmpty() ? -1 : open_elements.last();
+            element.child_index    = 0;
+            element.children_start = 0;
+            element.children_count = 0;
+
+            if (element.parent != -1) {
+                element.child_index = m_ElementOffsets[ element.parent ].children_count++;
             }
 
-            StackElement new_element;
-            new_element.name         = reader.name().toString();
-            new_element.num_children = 0;
-            stack.push(new_element);
-
-            // Check if this is the element start tag
-            // we are looking for
-            if (reader.characterOffset() == offset) {
-                break;
+            if (m_ElementOffsetsRoot == -1 && reader.qualifiedName() == "html") {
+                m_ElementOffsetsRoot = m_ElementOffsets.count();
             }
-        }
-        // If we detect the end tag of an element,
-        // we remove it from the top of the stack
-        else if (reader.isEndElement()) {
-            stack.pop();
+
+            open_elements.append(m_ElementOffsets.count());
+            m_ElementOffsets.append(element);
+        } else if (reader.isEndElement() && !open_elements.isEmpty()) {
+            open_elements.removeLast();
         }
     }
 
     if (reader.hasError()) {
-        // Just return an empty location.
-        // Maybe we could return the stack we currently have?
-        return QStack< StackElement >();
+        m_ElementOffsetsError = reader.characterOffset();
+    }
+
+    // Lay out the child lists next to each other, in document order
+    int children_start = 0;
+
+    for (int i = 0; i < m_ElementOffsets.count(); ++i) {
+        m_ElementOffsets[ i ].children_start = children_start;
+        children_start += m_ElementOffsets.at(i).children_count;
+    }
+
+    m_ElementChildren.resize(children_start);
+
+    for (int i = 0; i < m_ElementOffsets.count(); ++i) {
+        const ElementOffset &element = m_ElementOffsets.at(i);
+
+        if (element.parent != -1) {
+            m_ElementChildren[ m_ElementOffsets.at(element.parent).children_start + element.child_index ] = i;
+        }
     }
 
-    return stack;
+    m_ElementOffsetsValid = true;
 }
 
 
-QList< ViewEditor::ElementIndex > CodeViewEditor::ConvertStackToHierarchy(const QStack< StackElement > stack) const
+int CodeViewEditor::ConvertHierarchyToCaretPosition(const QList< ViewEditor::ElementIndex > &hierarchy)
 {
-    QList< ViewEditor::ElementIndex > hierarchy;
-    foreach(StackElement stack_element, stack) {
-        ViewEditor::ElementIndex new_element;
-        new_element.name  = stack_element.name;
-        new_element.index = stack_element.num_children - 1;
-        hierarchy.append(new_element);
+    UpdateElementOffsets();
+
+    if (m_ElementOffsetsError != -1) {
+        return -1;
     }
-    return hierarchy;
+
+    // Same walk as XhtmlDoc::GetNodeFromHierarchy. The last entry only
+    // names the target node, its index is -1 and is never used.
+    if (m_ElementOffsetsRoot == -1 || hierarchy.count() < 2) {
+        return 0;
+    }
+
+    int node = m_ElementOffsetsRoot;
+
+    for (int i = 0; i < hierarchy.count() - 1; ++i) {
+        const ElementOffset &element = m_ElementOffsets.at(node);
+
+        // The index counts text nodes as well when the next node is
+        // text, and we only index elements. The caret is nearly always
+        // in a text node, which we resolve to its parent element.
+        if (hierarchy[ i + 1 ].name == "#text") {
+            if (i + 1 == hierarchy.count() - 1) {
+                break;
+            }
+
+            return -1;
+        }
+
+        if (hierarchy[ i ].index < 0) {
+            return -1;
+        }
+
+        // If the asked-for node cannot be found, we stop where we are
+        if (hierarchy[ i ].index >= element.children_count) {
+            break;
+        }
+
+        node = m_ElementChildren.at(element.children_start + hierarchy[ i ].index);
+    }
+
+    return m_ElementOffsets.at(node).tag_end;
 }
 
 
@@ -2274,18 +2391,24 @@ bool CodeViewEditor::ExecuteCaretUpdate(bool default_to_top)
     }
 
     QTextCursor cursor(document());
-    int vertical_lines_move = 0;
-    int horizontal_chars_move = 0;
     // We *have* to do the conversion on-demand since the
-    // conversion uses toPlainText(), and the text needs to up-to-date.
-    tie(vertical_lines_move, horizontal_chars_move) = ConvertHierarchyToCaretMove(m_CaretUpdate);
-    cursor.movePosition(QTextCursor::NextBlock, QTextCursor::MoveAnchor, vertical_lines_move - 1);
+    // conversion uses the text, and the text needs to up-to-date.
+    int position = ConvertHierarchyToCaretPosition(m_CaretUpdate);
 
-    for (int i = 1 ; i < horizontal_chars_move ; i++) {
-        cursor.movePosition(QTextCursor::NextCharacter , QTextCursor::MoveAnchor);
-        // TODO: cursor.movePosition( QTextCursor::Left, ...) is badly bugged in Qt 4.7.
-        // Test whether it's fixed when the next version of Qt comes out.
-        // cursor.movePosition( QTextCursor::Left, QTextCursor::MoveAnchor, horizontal_chars_move );
+    if (position != -1) {
+        cursor.setPosition(position);
+    } else {
+        int vertical_lines_move = 0;
+        int horizontal_chars_move = 0;
+        tie(vertical_lines_move, horizontal_chars_move) = ConvertHierarchyToCaretMove(m_CaretUpdate);
+        cursor.movePosition(QTextCursor::NextBlock, QTextCursor::MoveAnchor, vertical_lines_move - 1);
+
+        for (int i = 1 ; i < horizontal_chars_move ; i++) {
+            cursor.movePosition(QTextCursor::NextCharacter , QTextCursor::MoveAnchor);
+            // TODO: cursor.movePosition( QTextCursor::Left, ...) is badly bugged in Qt 4.7.
+            // Test whether it's fixed when the next version of Qt comes out.
+            // cursor.movePosition( QTextCursor::Left, QTextCursor::MoveAnchor, horizontal_chars_move );
+        }
     }
 
     m_CaretUpdate.clear();
@@ -3529,6 +3652,7 @@ void CodeViewEditor::ConnectSignalsToSlots()
     connect(this, SIGNAL(cursorPositionChanged()), this, SLOT(EmitFilteredCursorMoved()));
     connect(this, SIGNAL(textChanged()), this, SIGNAL(PageUpdated()));
     connect(this, SIGNAL(textChanged()), this, SLOT(TextChangedFilter()));
+    connect(this, SIGNAL(textChanged()), this, SLOT(ResetTextCaches()));
     connect(this, SIGNAL(undoAvailable(bool)), this, SLOT(UpdateUndoAvailable(bool)));
     connect(this, SIGNAL(selectionChanged()), this, SLOT(ResetLastFindMatch()));
     connect(&m_ScrollOneLineUp,   SIGNAL(activated()), this, SLOT(ScrollOneLineUp()));
@@ -26,7 +26,7 @@
 #include <boost/tuple/tuple.hpp>
 
 #include <QtCore/QList>
-#include <QtCore/QStack>
+#include <QtCore/QVector>
 #include <QtWidgets/QPlainTextEdit>
 #include <QtGui/QStandardItem>
 #include <QtCore/QUrl>
@@ -469,6 +469,11 @@ private slots:
 
     void RehighlightDocument();
 
+    /**
+     * Drops the cached copy of the document text and the element index.
+     */
+    void ResetTextCaches();
+
     void PasteClipEntryFromName(const QString &name);
 
     /**
@@ -529,6 +534,18 @@ private slots:
 private:
     bool IsMarkedText();
 
+    /**
+     * Returns the length of the plain text, without copying it.
+     */
+    int GetDocumentLength() const;
+
+    /**
+     * Returns the plain text of the document for searching. Every call to
+     * toPlainText() builds a new copy of the whole document, so we keep
+     * one around until the document changes.
+     */
+    QString GetSearchText();
+
     QString GetCurrentWordAtCaret(bool select_word);
 
     bool PasteClipEntry(ClipEditorModel::clipEntry *clip);
@@ -602,45 +619,60 @@ private:
     bool InViewableImage();
 
     /**
-     * An element on the stack when searching for
-     * the current caret location.
+     * An element of the document, as recorded in the element index.
      */
-    struct StackElement {
+    struct ElementOffset {
         /**
          * The tag name.
          */
         QString name;
 
         /**
-         * The number of child elements
-         * detected for the element, so far.
+         * The offsets of the start tag's opening
+         * bracket and of the character after it.
+         */
+        int tag_start;
+        int tag_end;
+
+        /**
+         * The index of the parent element in the
+         * element index, or -1 for the root element.
+         */
+        int parent;
+
+        /**
+         * The index of this element in its parent's list of child elements.
          */
-        int num_children;
+        int child_index;
+
+        /**
+         * Where the indexes of the child elements
+         * start in m_ElementChildren, and how many there are.
+         */
+        int children_start;
+        int children_count;
     };
 
     /**
-     * Returns a stack of elements representing the
-     * current location of the caret in the document.
-     *
-     * @param offset The number of characters from document start to the end of
-     *               the start tag of the element the caret is residing in.
-     * @return The element location stack.
+     * Builds the element index for the current text,
+     * unless it has already been built.
      */
-    QStack< StackElement > GetCaretLocationStack(int offset) const;
+    void UpdateElementOffsets();
 
     /**
-     * Takes the stack provided by GetCaretLocationStack()
-     * and converts it into the element location hierarchy
-     * used by other ViewEditors.
+     * Returns the caret position the ViewEditor element hierarchy points to,
+     * or -1 if the element index cannot resolve it (text nodes or bad XML).
      *
-     * @param stack The StackElement stack.
-     * @return The converted ElementIndex hierarchy.
+     * @param hierarchy The caret location as ElementIndex hierarchy.
+     * @return The position to move the caret to.
      */
-    QList< ElementIndex > ConvertStackToHierarchy(const QStack< StackElement > stack) const;
+    int ConvertHierarchyToCaretPosition(const QList< ViewEditor::ElementIndex > &hierarchy);
 
     /**
      * Converts a ViewEditor element hierarchy to a tuple describing necessary caret moves.
-     * The tuple contains the vertical lines and horizontal chars move deltas
+     * The tuple contains the vertical lines and horizontal chars move deltas.
+     * This parses the text, so it is only used for hierarchies that
+     * ConvertHierarchyToCaretPosition() cannot resolve.
      *
      * @param hierarchy The caret location as ElementIndex hierarchy.
      * @return The info needed to move the caret to the new location.
@@ -798,6 +830,33 @@ private:
     SPCRE::MatchInfo m_lastMatch;
     QString m_lastFindRegex;
 
+    /**
+     * The document text used for searching, and the document it came
+     * from. A NULL document means the text has to be fetched again.
+     */
+    QString m_SearchText;
+    QTextDocument *m_SearchTextDocument;
+
+    /**
+     * Every element of the text in document order, so that caret locations
+     * can be converted to and from element hierarchies without parsing the
+     * text each time. Built on demand and dropped when the text changes.
+     */
+    QVector< ElementOffset > m_ElementOffsets;
+    QVector< int > m_ElementChildren;
+    bool m_ElementOffsetsValid;
+
+    /**
+     * The index of the html element, or -1.
+     */
+    int m_ElementOffsetsRoot;
+
+    /**
+     * The offset where the text stopped being well formed, or -1.
+     * Elements after it are not in the index.
+     */
+    int m_ElementOffsetsError;
+
     /**
      * Map spelling suggestion actions from the context menu to the
      * ReplaceSelected slot.
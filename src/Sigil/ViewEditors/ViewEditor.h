@@ -71,6 +71,10 @@ public:
          * The index of this element in its parent's list of children.
          */
         int index;
+
+        bool operator==(const ElementIndex &other) const {
+            return index == other.index && name == other.name;
+        }
     };
 
     /**
@@ -35,6 +35,7 @@
 #include "MainUI/MainApplication.h"
 #include "MainUI/MainWindow.h"
 #include "Misc/AppEventFilter.h"
+#include "Misc/BatchProcessor.h"
 #include "Misc/TempFolder.h"
 #include "Misc/UpdateChecker.h"
 #include "Misc/Utility.h"
@@ -254,6 +255,13 @@ int main(int argc, char *argv[])
 #ifndef Q_OS_WIN32
         CreateTempFolderWithCorrectPermissions();
 #endif
+        const QStringList &arguments = QCoreApplication::arguments();
+
+        // Headless runs don't show any windows or check for updates.
+        if (BatchProcessor::IsBatchRequested(arguments)) {
+            return BatchProcessor(arguments).Run();
+        }
+
         // Needs to be created on the heap so that
         // the reply has time to return.
         UpdateChecker *checker = new UpdateChecker(&app);
@@ -262,7 +270,6 @@ int main(int argc, char *argv[])
         // so we can catch OS X's file open events
         AppEventFilter *filter = new AppEventFilter(&app);
         app.installEventFilter(filter);
-        const QStringList &arguments = QCoreApplication::arguments();
 
         if (arguments.contains("-t")) {
             std::cout  << TempFolder::GetPathToSigilScratchpad().toStdString() << std::endl;